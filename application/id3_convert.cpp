@@ -0,0 +1,346 @@
+/**
+ * @file id3_convert.cpp
+ * @brief Convert ID3 tags between versions using the ID3 library
+ */
+
+#include <MP3File>
+#include <DirectoryWalker>
+#include <Journal>
+#include <TagConverter>
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+
+#ifdef _WIN32
+    #include <windows.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// Um conjunto de versões de destino, gravado no seu próprio diretório
+struct OutputSet {
+    uint32_t targets = 0;
+    fs::path path;
+};
+
+// Totals of the run, printed at the end
+struct ConvertReport {
+    int filesProcessed = 0;
+    int mp3sProcessed = 0;
+    int convertedCount = 0;
+    int notConverted = 0;
+    int resumed = 0;
+    int unreadable = 0;
+    int linked[3] = {0, 0, 0};
+};
+
+// Forward declarations
+fs::path prepareOutput(const fs::path& sourcePath, uint32_t targets, bool keepExisting);
+bool processDirectory(const fs::path& sourcePath, const std::vector<OutputSet>& outputs, TagProbe::Version from, int maxDepth, File::CopyMode copyMode, bool inPlace, Journal& journal, ConvertReport& report);
+
+int main(int argc, char* argv[]) {
+    int maxDepth = 0;
+    File::CopyMode copyMode = File::Reflink;
+    bool inPlace = false;
+    bool resume = false;
+    TagProbe::Version from = TagProbe::None;
+    std::vector<OutputSet> outputs;
+
+    std::vector<fs::path> args;
+    #ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+
+    // Obter argumentos em Unicode via WinAPI
+    LPWSTR* szArglist;
+    int nArgs;
+    szArglist = CommandLineToArgvW(GetCommandLineW(), &nArgs);
+    if (szArglist != NULL) {
+        for (int i = 1; i < nArgs; i++) {
+            args.emplace_back(szArglist[i]);
+        }
+        LocalFree(szArglist);
+    }
+    #else
+    for (int i = 1; i < argc; i++) {
+        args.emplace_back(argv[i]);
+    }
+    #endif
+
+    std::size_t argIndex = 0;
+    while (argIndex + 1 < args.size()) {
+        std::string option = args[argIndex].string();
+        if (option == "--max-depth" && argIndex + 2 < args.size()) {
+            maxDepth = std::atoi(args[argIndex + 1].string().c_str());
+            argIndex += 2;
+        } else if (option == "-r") {
+            maxDepth = -1;
+            argIndex++;
+        } else if (option == "--to" && argIndex + 2 < args.size()) {
+            OutputSet output;
+            if (!TagConverter::parseVersions(args[argIndex + 1].string(), output.targets)) {
+                std::cerr << "Error: Unknown versions " << args[argIndex + 1].string()
+                          << ", use v1.0, v1.1, v2.0, v2.3 or v2.4, at most one ID3v1 and one ID3v2 joined by '+'." << std::endl;
+                return 1;
+            }
+            outputs.push_back(output);
+            argIndex += 2;
+        } else if (option == "--from" && argIndex + 2 < args.size()) {
+            uint32_t versions = 0;
+            if (!TagConverter::parseVersions(args[argIndex + 1].string(), versions) || (versions & (versions - 1)) != 0) {
+                std::cerr << "Error: Unknown version " << args[argIndex + 1].string() << ", use v1.0, v1.1, v2.0, v2.3 or v2.4." << std::endl;
+                return 1;
+            }
+            from = static_cast<TagProbe::Version>(versions);
+            argIndex += 2;
+        } else if (option == "--in-place") {
+            inPlace = true;
+            argIndex++;
+        } else if (option == "--resume") {
+            resume = true;
+            argIndex++;
+        } else if (option == "--link" && argIndex + 2 < args.size()) {
+            if (!File::parseCopyMode(args[argIndex + 1].string(), copyMode)) {
+                std::cerr << "Error: Unknown link mode, use reflink, hardlink or copy." << std::endl;
+                return 1;
+            }
+            argIndex += 2;
+        } else {
+            break;
+        }
+    }
+    if (argIndex + 1 != args.size() || outputs.empty()) {
+        std::cout << "Usage: " << argv[0] << " [-r] [--max-depth N] [--from VERSION] [--link reflink|hardlink|copy | --in-place] [--resume]"
+                  << " --to VERSIONS [--to VERSIONS...] <source_directory>" << std::endl;
+        std::cout << "       VERSIONS: v1.0, v1.1, v2.0, v2.3 or v2.4, one ID3v1 and one ID3v2 may be joined, like v1.1+v2.4" << std::endl;
+        return 1;
+    }
+    if (inPlace && outputs.size() > 1) {
+        std::cerr << "Error: --in-place takes a single --to." << std::endl;
+        return 1;
+    }
+    fs::path sourcePath = args[argIndex];
+
+    std::cout << "=====================================" << std::endl;
+    std::cout << "  Convert ID3 Tags" << std::endl;
+    std::cout << "=====================================" << std::endl;
+
+    if (!fs::exists(sourcePath) || !fs::is_directory(sourcePath)) {
+        std::cerr << "Error: Source directory does not exist." << std::endl;
+        return 1;
+    }
+
+    // Com --in-place os arquivos são editados onde estão; senão cada --to tem seu diretório de saída
+    for (auto& output : outputs) {
+        output.path = inPlace ? sourcePath : prepareOutput(sourcePath, output.targets, resume);
+        if (output.path.empty()) {
+            return 1;
+        }
+    }
+
+    // The journal names the conversion, so --resume with other targets converts every file again
+    std::string job = "from=" + TagConverter::toString(from) + (inPlace ? " in-place" : "") + " to=";
+    for (std::size_t i = 0; i < outputs.size(); i++) {
+        job += (i > 0 ? "," : "") + TagConverter::toString(outputs[i].targets);
+    }
+    fs::path journalPath = sourcePath.parent_path() / ("." + sourcePath.filename().string() + ".id3_convert_journal");
+    Journal journal;
+    if (!journal.open(journalPath, resume, job)) {
+        std::cerr << "Error: Could not open journal " << journalPath.string() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Source: " << sourcePath.string() << std::endl;
+    for (const auto& output : outputs) {
+        std::cout << "Output: " << (inPlace ? "(in place)" : output.path.string()) << " (" << TagConverter::toString(output.targets) << ")" << std::endl;
+    }
+    std::cout << std::string(80, '-') << std::endl;
+
+    ConvertReport report;
+    if (!processDirectory(sourcePath, outputs, from, maxDepth, copyMode, inPlace, journal, report)) {
+        return 1;
+    }
+    // Files of unreadable directories are not done, the journal is kept so --resume only does them
+    if (report.unreadable == 0) {
+        journal.finish();
+    }
+
+    std::cout << std::string(80, '-') << std::endl;
+    std::cout << "Total files: " << report.filesProcessed << std::endl;
+    std::cout << "MP3 files: " << report.mp3sProcessed << std::endl;
+    std::cout << "Converted: " << report.convertedCount << " files" << std::endl;
+    if (report.notConverted > 0) {
+        std::cout << "Not converted: " << report.notConverted << " files with frames the target version can not hold" << std::endl;
+    }
+    if (!inPlace) {
+        std::cout << "Unchanged files: " << report.linked[File::Reflink] << " reflinked, " << report.linked[File::Hardlink]
+                  << " hard-linked, " << report.linked[File::Copy] << " copied" << std::endl;
+    }
+    if (resume) {
+        std::cout << "Resumed: " << report.resumed << " files finished by the interrupted run" << std::endl;
+    }
+    std::cout << "=====================================" << std::endl;
+
+    return report.unreadable == 0 ? 0 : 1;
+}
+
+// Implementações
+
+fs::path prepareOutput(const fs::path& sourcePath, uint32_t targets, bool keepExisting) {
+    std::string dirName = sourcePath.filename().string();
+
+    // Converting an output again names the new one after the original directory
+    std::size_t suffix = dirName.rfind(" - to v");
+    if (suffix != std::string::npos && suffix > 0)
+        dirName = dirName.substr(0, suffix);
+
+    fs::path outputPath = sourcePath.parent_path() / (dirName + " - to " + TagConverter::toString(targets));
+
+    try {
+        if (fs::exists(outputPath) && !keepExisting) fs::remove_all(outputPath);
+        fs::create_directories(outputPath);
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "Error creating output directory: " << e.what() << std::endl;
+        return fs::path();
+    }
+    return outputPath;
+}
+
+bool processDirectory(const fs::path& sourcePath, const std::vector<OutputSet>& outputs, TagProbe::Version from, int maxDepth, File::CopyMode copyMode, bool inPlace, Journal& journal, ConvertReport& report) {
+    TagConverter converter;
+
+    try {
+        DirectoryWalker walker;
+        walker.setMaxDepth(maxDepth);
+        std::vector<fs::path> files = walker.list(sourcePath);
+        if (walker.getSkippedLoops() > 0) {
+            std::cerr << "Skipped " << walker.getSkippedLoops() << " looping symbolic link(s)" << std::endl;
+        }
+        if (walker.getErrors() > 0) {
+            std::cerr << "Could not read " << walker.getErrors() << " directory(ies), their files were skipped" << std::endl;
+            report.unreadable = static_cast<int>(walker.getErrors());
+        }
+        for (const auto& file : files) {
+            // Relative to the source, so files of subdirectories keep their place in the output
+            std::string filename = file.lexically_relative(sourcePath).string();
+            report.filesProcessed++;
+
+            if (maxDepth != 0 && !inPlace) {
+                for (const auto& output : outputs) {
+                    fs::create_directories((output.path / filename).parent_path());
+                }
+            }
+
+            // A file is recorded once all its outputs are written; one changed since then is done again
+            ScanCache::Key key;
+            bool hasKey = ScanCache::getKey(file, key);
+            if (hasKey && journal.isDone(filename, key)) {
+                report.resumed++;
+                if (MP3File::isMP3File(filename)) {
+                    report.mp3sProcessed++;
+                    std::cout << std::setw(3) << std::setfill('0') << report.mp3sProcessed << ") "
+                              << filename << " = Resumed" << std::endl;
+                }
+                continue;
+            }
+
+            if (!MP3File::isMP3File(filename)) {
+                bool saved = true;
+                std::string path_utf8 = file.u8string();
+                for (const auto& output : outputs) {
+                    if (inPlace) {
+                        break;
+                    }
+                    std::string output_utf8 = (output.path / filename).u8string();
+                    File::CopyMode used = File::Copy;
+                    if (File::copy(path_utf8.c_str(), output_utf8.c_str(), copyMode, &used)) {
+                        report.linked[used]++;
+                    } else {
+                        std::cerr << "Error copying file " << filename << std::endl;
+                        saved = false;
+                    }
+                }
+                if (saved && hasKey) {
+                    journal.markDone(filename, key);
+                }
+                continue;
+            }
+
+            report.mp3sProcessed++;
+            std::cout << std::setw(3) << std::setfill('0') << report.mp3sProcessed << ") " << filename << " = ";
+
+            // Only the tags are read, once for all outputs: the audio is spliced from the source when saving
+            MP3File mp3;
+            mp3.setLazyFrames(true);
+            std::string path_utf8 = file.u8string();
+            if (!mp3.loadTags(path_utf8.c_str())) {
+                std::cout << "Failed to load" << std::endl;
+                continue;
+            }
+
+            bool hasSource = converter.read(mp3, from);
+            bool saved = true;
+            bool converted = false;
+            uint32_t failed = TagProbe::None;
+            for (const auto& output : outputs) {
+                fs::path outputFile = output.path / filename;
+                std::string output_utf8 = outputFile.u8string();
+
+                // Um frame que a versão alvo não comporta deixa o arquivo como está, sem perder o frame
+                ID3 id3 = mp3.getID3();
+                File::CopyMode used = File::Copy;
+                uint32_t outputFailed = TagProbe::None;
+                bool changed = hasSource && converter.convert(output.targets, id3, &outputFailed);
+                failed |= outputFailed;
+                if (changed && outputFailed == TagProbe::None) {
+                    converted = true;
+                    if (!mp3.saveID3(path_utf8.c_str(), id3, inPlace ? nullptr : output_utf8.c_str())) {
+                        std::cerr << "    Failed to save: " << outputFile.string() << std::endl;
+                        saved = false;
+                    }
+                } else if (!inPlace) {
+                    if (File::copy(path_utf8.c_str(), output_utf8.c_str(), copyMode, &used)) {
+                        report.linked[used]++;
+                    } else {
+                        std::cerr << "    Failed to save: " << outputFile.string() << std::endl;
+                        saved = false;
+                    }
+                }
+            }
+
+            if (!hasSource) {
+                std::string missing = from == TagProbe::None ? "No tags" : "No ID3" + TagConverter::toString(from) + " tag";
+                std::cout << missing << (inPlace ? " (unchanged)" : " (copied)") << std::endl;
+            } else if (failed != TagProbe::None) {
+                std::cout << "Not converted to " << TagConverter::toString(failed) << ": a frame can not be carried over"
+                          << (inPlace ? " (unchanged)" : " (copied)") << std::endl;
+            } else {
+                std::cout << (converted ? "Converted " : "Unchanged ") << "ID3" << TagConverter::toString(converter.getSource()) << " to ";
+                for (std::size_t i = 0; i < outputs.size(); i++) {
+                    std::cout << (i > 0 ? ", " : "") << TagConverter::toString(outputs[i].targets);
+                }
+                std::cout << std::endl;
+            }
+            if (failed != TagProbe::None) {
+                report.notConverted++;
+            } else if (converted) {
+                report.convertedCount++;
+            }
+
+            // Editado no lugar, o arquivo gravado é o que o journal reconhece numa retomada
+            if (saved && inPlace && converted) {
+                hasKey = ScanCache::getKey(file, key);
+            }
+            if (saved && hasKey) {
+                journal.markDone(filename, key);
+            }
+        }
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "Filesystem error: " << e.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -4,12 +4,15 @@
  */
 
 #include <MP3File>
+#include <DirectoryWalker>
+#include <Journal>
 #include <iostream>
 #include <filesystem>
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <sstream>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -17,14 +20,31 @@
 
 namespace fs = std::filesystem;
 
+// Lines of the initial scan and of both removals, produced by the single pass over the source
+struct PassReport {
+    std::vector<std::string> scanLines;
+    std::vector<std::string> noV1Lines;
+    std::vector<std::string> noV2Lines;
+    int mp3Count = 0;
+    int resumed = 0;
+    int unreadable = 0;
+    int linked[3] = {0, 0, 0};
+};
+
 // Forward declarations
-bool isMp3File(const std::string& filename);
 std::string getID3Versions(const MP3File& mp3);
-void scanDirectory(const fs::path& dirPath);
-fs::path processDirectory(const fs::path& sourcePath, bool removeV1);
+bool scanDirectory(const fs::path& dirPath, int maxDepth);
+fs::path prepareOutput(const fs::path& sourcePath, bool removeV1, bool keepExisting);
+bool processDirectory(const fs::path& sourcePath, const fs::path& noV1Path, const fs::path& noV2Path, int maxDepth, File::CopyMode copyMode, Journal& journal, PassReport& report);
+void printRemoval(const fs::path& sourcePath, const fs::path& outputPath, bool removeV1, const PassReport& report);
 std::string toAnsiPath(const fs::path& path);
 
 int main(int argc, char* argv[]) {
+    int maxDepth = 0;
+    File::CopyMode copyMode = File::Reflink;
+    bool resume = false;
+
+    std::vector<fs::path> args;
     #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
     
@@ -32,48 +52,117 @@ int main(int argc, char* argv[]) {
     LPWSTR* szArglist;
     int nArgs;
     szArglist = CommandLineToArgvW(GetCommandLineW(), &nArgs);
-    if (szArglist == NULL || nArgs < 2) {
-        std::cout << "Usage: " << argv[0] << " <source_directory>" << std::endl;
-        return 1;
+    if (szArglist != NULL) {
+        for (int i = 1; i < nArgs; i++) {
+            args.emplace_back(szArglist[i]);
+        }
+        LocalFree(szArglist);
     }
-    
-    fs::path sourcePath(szArglist[1]);
-    LocalFree(szArglist);
     #else
-    if (argc < 2) {
-        std::cout << "Usage: " << argv[0] << " <source_directory>" << std::endl;
-        return 1;
+    for (int i = 1; i < argc; i++) {
+        args.emplace_back(argv[i]);
     }
-    fs::path sourcePath(argv[1]);
     #endif
+
+    std::size_t argIndex = 0;
+    while (argIndex + 1 < args.size()) {
+        std::string option = args[argIndex].string();
+        if (option == "--max-depth" && argIndex + 2 < args.size()) {
+            maxDepth = std::atoi(args[argIndex + 1].string().c_str());
+            argIndex += 2;
+        } else if (option == "-r") {
+            maxDepth = -1;
+            argIndex++;
+        } else if (option == "--resume") {
+            resume = true;
+            argIndex++;
+        } else if (option == "--link" && argIndex + 2 < args.size()) {
+            if (!File::parseCopyMode(args[argIndex + 1].string(), copyMode)) {
+                std::cerr << "Error: Unknown link mode, use reflink, hardlink or copy." << std::endl;
+                return 1;
+            }
+            argIndex += 2;
+        } else {
+            break;
+        }
+    }
+    if (argIndex + 1 != args.size()) {
+        std::cout << "Usage: " << argv[0] << " [-r] [--max-depth N] [--link reflink|hardlink|copy] [--resume] <source_directory>" << std::endl;
+        return 1;
+    }
+    fs::path sourcePath = args[argIndex];
     
     std::cout << "=====================================" << std::endl;
     std::cout << "  Full ID3 Removal Pipeline" << std::endl;
     std::cout << "=====================================" << std::endl;
     
+    if (!fs::exists(sourcePath) || !fs::is_directory(sourcePath)) {
+        std::cerr << "Error: Source directory does not exist." << std::endl;
+        return 1;
+    }
+
+    // Com --resume as saídas do job interrompido são mantidas e o journal diz quais arquivos já terminaram
+    fs::path noV1Path = prepareOutput(sourcePath, true, resume);
+    fs::path noV2Path = prepareOutput(sourcePath, false, resume);
+    if (noV1Path.empty() || noV2Path.empty()) {
+        return 1;
+    }
+
+    fs::path journalPath = noV1Path.parent_path() / ("." + sourcePath.filename().string() + ".id3_journal");
+    Journal journal;
+    if (!journal.open(journalPath, resume)) {
+        std::cerr << "Error: Could not open journal " << journalPath.string() << std::endl;
+        return 1;
+    }
+
+    // The tags of each source file are read once for the initial scan and both outputs, the audio is copied by the kernel
+    PassReport report;
+    if (!processDirectory(sourcePath, noV1Path, noV2Path, maxDepth, copyMode, journal, report)) {
+        return 1;
+    }
+    // Files of unreadable directories are not done, the journal is kept so --resume only does them
+    if (report.unreadable == 0) {
+        journal.finish();
+    }
+    bool complete = report.unreadable == 0;
+    
     // 1. Scan original
     std::cout << std::endl;
     std::cout << "INITIAL SCAN" << std::endl;
-    scanDirectory(sourcePath);
+    std::cout << std::endl;
+    std::cout << "SCANNING: " << sourcePath.string() << std::endl;
+    std::cout << std::string(80, '-') << std::endl;
+    for (const auto& line : report.scanLines) {
+        std::cout << line << '\n';
+    }
+    std::cout << std::string(80, '-') << std::endl;
+    std::cout << "Total MP3 files: " << report.mp3Count << std::endl;
     
     // 2. Remove ID3v1 from original
-    fs::path noV1Path = processDirectory(sourcePath, true);
+    printRemoval(sourcePath, noV1Path, true, report);
     
-    // 3. Scan No ID3v1
-    scanDirectory(noV1Path);
+    // 3. Scan No ID3v1, headers and trailers only
+    complete = scanDirectory(noV1Path, maxDepth) && complete;
     
     // 4. Remove ID3v2 from original (not from No ID3v1!)
-    fs::path noV2Path = processDirectory(sourcePath, false);
+    printRemoval(sourcePath, noV2Path, false, report);
     
-    // 5. Scan No ID3v2
-    scanDirectory(noV2Path);
+    // 5. Scan No ID3v2, headers and trailers only
+    complete = scanDirectory(noV2Path, maxDepth) && complete;
+    
+    std::cout << std::endl;
+    std::cout << "Unchanged files: " << report.linked[File::Reflink] << " reflinked, " << report.linked[File::Hardlink]
+              << " hard-linked, " << report.linked[File::Copy] << " copied" << std::endl;
+    if (resume) {
+        std::cout << "Resumed: " << report.resumed << " files finished by the interrupted run" << std::endl;
+    }
     
     std::cout << std::endl;
     std::cout << "=====================================" << std::endl;
-    std::cout << "  Pipeline Complete!" << std::endl;
+    std::cout << (complete ? "  Pipeline Complete!" : "  Pipeline Incomplete!") << std::endl;
     std::cout << "=====================================" << std::endl;
     
-    return 0;
+    return complete ? 0 : 1;
 }
 
 // Implementações
@@ -90,76 +179,58 @@ std::string toAnsiPath(const fs::path& path) {
     #endif
 }
 
-bool isMp3File(const std::string& filename) {
-    if (filename.length() < 4) return false;
-    std::string ext = filename.substr(filename.length() - 4);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-    return ext == ".mp3";
-}
-
 std::string getID3Versions(const MP3File& mp3) {
-    std::vector<std::string> versions;
-    
-    if (mp3.hasID3v10()) versions.push_back("ID3v1.0");
-    if (mp3.hasID3v11()) versions.push_back("ID3v1.1");
-    if (mp3.hasID3v20()) versions.push_back("ID3v2.0");
-    if (mp3.hasID3v23()) versions.push_back("ID3v2.3");
-    if (mp3.hasID3v24()) versions.push_back("ID3v2.4");
-    
-    if (versions.empty()) return "No ID3 tags found";
-    
-    std::string result;
-    for (size_t i = 0; i < versions.size(); ++i) {
-        result += versions[i];
-        if (i < versions.size() - 1) result += ", ";
-    }
-    
-    return result;
+    return mp3.getTagProbe().toString();
 }
 
-void scanDirectory(const fs::path& dirPath) {
+bool scanDirectory(const fs::path& dirPath, int maxDepth) {
     std::cout << std::endl;
     std::cout << "SCANNING: " << dirPath.string() << std::endl;
     std::cout << std::string(80, '-') << std::endl;
     
     int fileCount = 0;
+    bool complete = true;
     
     try {
-        for (const auto& entry : fs::directory_iterator(dirPath)) {
-            if (entry.is_regular_file()) {
-                std::string filename = entry.path().filename().string();
+        DirectoryWalker walker;
+        walker.setMaxDepth(maxDepth);
+        std::vector<fs::path> files = walker.list(dirPath);
+        if (walker.getSkippedLoops() > 0) {
+            std::cerr << "Skipped " << walker.getSkippedLoops() << " looping symbolic link(s)" << std::endl;
+        }
+        if (walker.getErrors() > 0) {
+            std::cerr << "Could not read " << walker.getErrors() << " directory(ies), their files were skipped" << std::endl;
+            complete = false;
+        }
+        for (const auto& file : files) {
+            std::string filename = file.lexically_relative(dirPath).string();
+            
+            if (MP3File::isMP3File(filename)) {
+                fileCount++;
                 
-                if (isMp3File(filename)) {
-                    fileCount++;
-                    
-                    MP3File mp3;
-                    std::string path_utf8 = entry.path().u8string();
-                    if (mp3.load(path_utf8.c_str())) {
-                        std::string versions = getID3Versions(mp3);
-                        std::cout << std::setw(2) << std::setfill('0') << fileCount << ") " 
-                                  << filename << " = " << versions << std::endl;
-                    } else {
-                        std::cout << std::setw(2) << std::setfill('0') << fileCount << ") " 
-                                  << filename << " = Failed to load" << std::endl;
-                    }
+                MP3File mp3;
+                std::string path_utf8 = file.u8string();
+                if (mp3.loadTags(path_utf8.c_str())) {
+                    std::string versions = getID3Versions(mp3);
+                    std::cout << std::setw(2) << std::setfill('0') << fileCount << ") " 
+                              << filename << " = " << versions << std::endl;
+                } else {
+                    std::cout << std::setw(2) << std::setfill('0') << fileCount << ") " 
+                              << filename << " = Failed to load" << std::endl;
                 }
             }
         }
     } catch (const fs::filesystem_error& e) {
         std::cerr << "Filesystem error: " << e.what() << std::endl;
-        return;
+        return false;
     }
     
     std::cout << std::string(80, '-') << std::endl;
     std::cout << "Total MP3 files: " << fileCount << std::endl;
+    return complete;
 }
 
-fs::path processDirectory(const fs::path& sourcePath, bool removeV1) {
-    if (!fs::exists(sourcePath) || !fs::is_directory(sourcePath)) {
-        std::cerr << "Error: Source directory does not exist." << std::endl;
-        return sourcePath;
-    }
-    
+fs::path prepareOutput(const fs::path& sourcePath, bool removeV1, bool keepExisting) {
     std::string dirName = sourcePath.filename().string();
     
     if (dirName.length() > 12 && dirName.substr(dirName.length() - 12) == " - No ID3v1")
@@ -172,7 +243,7 @@ fs::path processDirectory(const fs::path& sourcePath, bool removeV1) {
     fs::path outputPath = parentPath / (dirName + suffix);
     
     // Se o diretório existe, remove completamente
-    if (fs::exists(outputPath)) {
+    if (fs::exists(outputPath) && !keepExisting) {
         try {
             fs::remove_all(outputPath);
         } catch (const fs::filesystem_error& e) {
@@ -200,97 +271,142 @@ fs::path processDirectory(const fs::path& sourcePath, bool removeV1) {
         fs::create_directories(outputPath);
     } catch (const fs::filesystem_error& e) {
         std::cerr << "Error: Could not create output directory: " << e.what() << std::endl;
-        return sourcePath;
+        return fs::path();
     }
     
-    std::cout << std::endl;
-    if (removeV1) {
-        std::cout << "REMOVING ID3v1 TAGS" << std::endl;
-    } else {
-        std::cout << "REMOVING ID3v2 TAGS" << std::endl;
-    }
-    std::cout << "Source: " << sourcePath.string() << std::endl;
-    std::cout << "Output: " << outputPath.string() << std::endl;
-    std::cout << std::string(80, '-') << std::endl;
-    
+    return outputPath;
+}
+
+bool processDirectory(const fs::path& sourcePath, const fs::path& noV1Path, const fs::path& noV2Path, int maxDepth, File::CopyMode copyMode, Journal& journal, PassReport& report) {
     int mp3sProcessed = 0;
-    int removedCount = 0;
     
     try {
-        for (const auto& entry : fs::directory_iterator(sourcePath)) {
-            std::string filename = entry.path().filename().string();
-            
-            if (entry.is_regular_file()) {
-                if (isMp3File(filename)) {
-                    mp3sProcessed++;
-                    
-                    MP3File mp3;
-                    std::string path_utf8 = entry.path().u8string();
-                    if (mp3.load(path_utf8.c_str())) {
-                        bool hasTag = false;
-                        std::string action;
-                        
-                        if (removeV1) {
-                            hasTag = mp3.hasID3v10() || mp3.hasID3v11();
-                            if (hasTag) {
-                                ID3 id3 = mp3.getID3();
-                                id3.v1.clear();
-                                mp3.setID3(id3);
-                                removedCount++;
-                                action = "ID3v1 removed";
-                            } else {
-                                action = "No ID3v1 tag (copied)";
-                            }
-                        } else {
-                            hasTag = mp3.hasID3v20() || mp3.hasID3v23() || mp3.hasID3v24();
-                            if (hasTag) {
-                                ID3 id3 = mp3.getID3();
-                                id3.v2.clear();
-                                mp3.setID3(id3);
-                                removedCount++;
-                                action = "ID3v2 removed";
-                            } else {
-                                action = "No ID3v2 tag (copied)";
-                            }
-                        }
-                        
-                        std::cout << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " 
-                                  << filename << " = " << action << std::endl;
-                        
-                        fs::path outputFile = outputPath / filename;
-                        std::string output_utf8 = outputFile.u8string();
-                        if (!mp3.save(output_utf8.c_str())) {
-                            std::cerr << "    Failed to save: " << filename << std::endl;
-                        }
+        DirectoryWalker walker;
+        walker.setMaxDepth(maxDepth);
+        std::vector<fs::path> files = walker.list(sourcePath);
+        if (walker.getSkippedLoops() > 0) {
+            std::cerr << "Skipped " << walker.getSkippedLoops() << " looping symbolic link(s)" << std::endl;
+        }
+        if (walker.getErrors() > 0) {
+            std::cerr << "Could not read " << walker.getErrors() << " directory(ies), their files were skipped" << std::endl;
+            report.unreadable = static_cast<int>(walker.getErrors());
+        }
+        for (const auto& file : files) {
+            // Relative to the source, so files of subdirectories keep their place in the output
+            std::string filename = file.lexically_relative(sourcePath).string();
+            fs::path noV1File = noV1Path / filename;
+            fs::path noV2File = noV2Path / filename;
+
+            if (maxDepth != 0) {
+                fs::create_directories(noV1File.parent_path());
+                fs::create_directories(noV2File.parent_path());
+            }
+
+            // A file is recorded once both outputs are written; one changed since then is done again
+            ScanCache::Key key;
+            bool hasKey = ScanCache::getKey(file, key);
+            bool resumed = hasKey && journal.isDone(filename, key);
+            if (resumed) {
+                report.resumed++;
+            }
+
+            if (!MP3File::isMP3File(filename)) {
+                bool saved = true;
+                std::string path_utf8 = file.u8string();
+                for (const auto& outputFile : {noV1File, noV2File}) {
+                    if (resumed) {
+                        break;
+                    }
+                    std::string output_utf8 = outputFile.u8string();
+                    File::CopyMode used = File::Copy;
+                    if (File::copy(path_utf8.c_str(), output_utf8.c_str(), copyMode, &used)) {
+                        report.linked[used]++;
                     } else {
-                        std::cout << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " 
-                                  << filename << " = Failed to load" << std::endl;
+                        std::cerr << "Error copying file " << filename << std::endl;
+                        saved = false;
                     }
-                } else {
-                    fs::path outputFile = outputPath / filename;
-                    try {
-                        // Se o arquivo existe, tenta remover primeiro
-                        if (fs::exists(outputFile)) {
-                            try {
-                                fs::remove(outputFile);
-                            } catch (...) {
-                                // Ignora erro de remoção, tentará sobrescrever
-                            }
-                        }
-                        fs::copy_file(entry.path(), outputFile, fs::copy_options::overwrite_existing);
-                    } catch (const fs::filesystem_error& e) {
-                        std::cerr << "Error copying file " << filename << ": " << e.what() << std::endl;
+                }
+                if (!resumed && saved && hasKey) {
+                    journal.markDone(filename, key);
+                }
+                continue;
+            }
+
+            mp3sProcessed++;
+            std::ostringstream scanLine;
+            std::ostringstream noV1Line;
+            std::ostringstream noV2Line;
+            scanLine << std::setw(2) << std::setfill('0') << mp3sProcessed << ") " << filename << " = ";
+            noV1Line << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " << filename << " = ";
+            noV2Line << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " << filename << " = ";
+
+            // Only the tags are read, the outputs are copied from file to file by the kernel (reflink or
+            // copy_file_range), so the audio never goes through this process
+            MP3File mp3;
+            std::string path_utf8 = file.u8string();
+            if (mp3.loadTags(path_utf8.c_str())) {
+                bool hasV1 = mp3.hasID3v10() || mp3.hasID3v11();
+                bool hasV2 = mp3.hasID3v20() || mp3.hasID3v23() || mp3.hasID3v24();
+                scanLine << getID3Versions(mp3);
+                noV1Line << (hasV1 ? "ID3v1 removed" : "No ID3v1 tag (copied)");
+                noV2Line << (hasV2 ? "ID3v2 removed" : "No ID3v2 tag (copied)");
+
+                if (!resumed) {
+                    // Without the tag to remove the output has the same bytes, linked instead of written
+                    File::CopyMode usedV1 = File::Copy;
+                    std::string noV1_utf8 = noV1File.u8string();
+                    bool savedV1 = hasV1 ? mp3.saveWithoutTags(path_utf8.c_str(), noV1_utf8.c_str(), true, false) : File::copy(path_utf8.c_str(), noV1_utf8.c_str(), copyMode, &usedV1);
+                    if (savedV1 && !hasV1) {
+                        report.linked[usedV1]++;
+                    } else if (!savedV1) {
+                        std::cerr << "    Failed to save: " << noV1File.string() << std::endl;
+                    }
+                    File::CopyMode usedV2 = File::Copy;
+                    std::string noV2_utf8 = noV2File.u8string();
+                    bool savedV2 = hasV2 ? mp3.saveWithoutTags(path_utf8.c_str(), noV2_utf8.c_str(), false, true) : File::copy(path_utf8.c_str(), noV2_utf8.c_str(), copyMode, &usedV2);
+                    if (savedV2 && !hasV2) {
+                        report.linked[usedV2]++;
+                    } else if (!savedV2) {
+                        std::cerr << "    Failed to save: " << noV2File.string() << std::endl;
+                    }
+                    if (savedV1 && savedV2 && hasKey) {
+                        journal.markDone(filename, key);
                     }
                 }
+            } else {
+                scanLine << "Failed to load";
+                noV1Line << "Failed to load";
+                noV2Line << "Failed to load";
             }
+
+            report.scanLines.push_back(scanLine.str());
+            report.noV1Lines.push_back(noV1Line.str());
+            report.noV2Lines.push_back(noV2Line.str());
         }
     } catch (const fs::filesystem_error& e) {
         std::cerr << "Filesystem error: " << e.what() << std::endl;
-        return sourcePath;
+        return false;
     }
     
+    report.mp3Count = mp3sProcessed;
+    return true;
+}
+
+void printRemoval(const fs::path& sourcePath, const fs::path& outputPath, bool removeV1, const PassReport& report) {
+    std::cout << std::endl;
+    if (removeV1) {
+        std::cout << "REMOVING ID3v1 TAGS" << std::endl;
+    } else {
+        std::cout << "REMOVING ID3v2 TAGS" << std::endl;
+    }
+    std::cout << "Source: " << sourcePath.string() << std::endl;
+    std::cout << "Output: " << outputPath.string() << std::endl;
     std::cout << std::string(80, '-') << std::endl;
-    std::cout << "MP3 files processed: " << mp3sProcessed << std::endl;
     
-    return outputPath;
+    for (const auto& line : removeV1 ? report.noV1Lines : report.noV2Lines) {
+        std::cout << line << '\n';
+    }
+    
+    std::cout << std::string(80, '-') << std::endl;
+    std::cout << "MP3 files processed: " << report.mp3Count << std::endl;
 }
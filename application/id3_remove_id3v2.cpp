@@ -4,9 +4,11 @@
  */
 
 #include <MP3File>
+#include <DirectoryWalker>
 #include <iostream>
 #include <filesystem>
 #include <string>
+#include <vector>
 #include <algorithm>
 #include <iomanip>
 
@@ -17,10 +19,14 @@
 namespace fs = std::filesystem;
 
 // Forward declarations
-bool isMp3File(const std::string& filename);
-void processDirectory(const fs::path& sourcePath);
+bool processDirectory(const fs::path& sourcePath, int maxDepth, File::CopyMode copyMode, bool inPlace);
 
 int main(int argc, char* argv[]) {
+    int maxDepth = 0;
+    File::CopyMode copyMode = File::Reflink;
+    bool inPlace = false;
+
+    std::vector<fs::path> args;
     #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
     
@@ -28,39 +34,55 @@ int main(int argc, char* argv[]) {
     LPWSTR* szArglist;
     int nArgs;
     szArglist = CommandLineToArgvW(GetCommandLineW(), &nArgs);
-    if (szArglist == NULL || nArgs < 2) {
-        std::cout << "Usage: " << argv[0] << " <source_directory>" << std::endl;
-        return 1;
+    if (szArglist != NULL) {
+        for (int i = 1; i < nArgs; i++) {
+            args.emplace_back(szArglist[i]);
+        }
+        LocalFree(szArglist);
     }
-    
-    fs::path sourcePath(szArglist[1]);
-    LocalFree(szArglist);
     #else
-    if (argc < 2) {
-        std::cout << "Usage: " << argv[0] << " <source_directory>" << std::endl;
-        return 1;
+    for (int i = 1; i < argc; i++) {
+        args.emplace_back(argv[i]);
     }
-    fs::path sourcePath(argv[1]);
     #endif
+
+    std::size_t argIndex = 0;
+    while (argIndex + 1 < args.size()) {
+        std::string option = args[argIndex].string();
+        if (option == "--max-depth" && argIndex + 2 < args.size()) {
+            maxDepth = std::atoi(args[argIndex + 1].string().c_str());
+            argIndex += 2;
+        } else if (option == "-r") {
+            maxDepth = -1;
+            argIndex++;
+        } else if (option == "--in-place") {
+            inPlace = true;
+            argIndex++;
+        } else if (option == "--link" && argIndex + 2 < args.size()) {
+            if (!File::parseCopyMode(args[argIndex + 1].string(), copyMode)) {
+                std::cerr << "Error: Unknown link mode, use reflink, hardlink or copy." << std::endl;
+                return 1;
+            }
+            argIndex += 2;
+        } else {
+            break;
+        }
+    }
+    if (argIndex + 1 != args.size()) {
+        std::cout << "Usage: " << argv[0] << " [-r] [--max-depth N] [--link reflink|hardlink|copy | --in-place] <source_directory>" << std::endl;
+        return 1;
+    }
+    fs::path sourcePath = args[argIndex];
     
-    processDirectory(sourcePath);
-    
-    return 0;
+    return processDirectory(sourcePath, maxDepth, copyMode, inPlace) ? 0 : 1;
 }
 
 // Implementações
 
-bool isMp3File(const std::string& filename) {
-    if (filename.length() < 4) return false;
-    std::string ext = filename.substr(filename.length() - 4);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-    return ext == ".mp3";
-}
-
-void processDirectory(const fs::path& sourcePath) {
+bool processDirectory(const fs::path& sourcePath, int maxDepth, File::CopyMode copyMode, bool inPlace) {
     if (!fs::exists(sourcePath) || !fs::is_directory(sourcePath)) {
         std::cerr << "Error: Source directory does not exist." << std::endl;
-        return;
+        return false;
     }
     
     std::string dirName = sourcePath.filename().string();
@@ -73,12 +95,19 @@ void processDirectory(const fs::path& sourcePath) {
     fs::path parentPath = sourcePath.parent_path();
     fs::path outputPath = parentPath / (dirName + " - No ID3v2");
     
+    // Com --in-place os arquivos são editados onde estão, sem diretório de saída
+    if (inPlace) {
+        outputPath = sourcePath;
+    }
+
     try {
-        if (fs::exists(outputPath)) fs::remove_all(outputPath);
-        fs::create_directories(outputPath);
+        if (!inPlace) {
+            if (fs::exists(outputPath)) fs::remove_all(outputPath);
+            fs::create_directories(outputPath);
+        }
     } catch (const fs::filesystem_error& e) {
         std::cerr << "Error creating output directory: " << e.what() << std::endl;
-        return;
+        return false;
     }
     
     std::cout << std::endl;
@@ -86,68 +115,103 @@ void processDirectory(const fs::path& sourcePath) {
     std::cout << "  Remove ID3v2 Tags" << std::endl;
     std::cout << "=====================================" << std::endl;
     std::cout << "Source: " << sourcePath.string() << std::endl;
-    std::cout << "Output: " << outputPath.string() << std::endl;
+    std::cout << "Output: " << (inPlace ? "(in place)" : outputPath.string()) << std::endl;
     std::cout << std::string(80, '-') << std::endl;
     
     int filesProcessed = 0;
     int mp3sProcessed = 0;
     int removedCount = 0;
+    int linked[3] = {0, 0, 0};
+    bool complete = true;
     
     try {
-        for (const auto& entry : fs::directory_iterator(sourcePath)) {
-            std::string filename = entry.path().filename().string();
+        DirectoryWalker walker;
+        walker.setMaxDepth(maxDepth);
+        std::vector<fs::path> files = walker.list(sourcePath);
+        if (walker.getSkippedLoops() > 0) {
+            std::cerr << "Skipped " << walker.getSkippedLoops() << " looping symbolic link(s)" << std::endl;
+        }
+        if (walker.getErrors() > 0) {
+            std::cerr << "Could not read " << walker.getErrors() << " directory(ies), their files were skipped" << std::endl;
+            complete = false;
+        }
+        for (const auto& file : files) {
+            // Relative to the source, so files of subdirectories keep their place in the output
+            std::string filename = file.lexically_relative(sourcePath).string();
+
+            filesProcessed++;
             
-            if (entry.is_regular_file()) {
-                filesProcessed++;
+            if (maxDepth != 0 && !inPlace) {
+                fs::create_directories((outputPath / filename).parent_path());
+            }
+
+            if (MP3File::isMP3File(filename)) {
+                mp3sProcessed++;
                 
-                if (isMp3File(filename)) {
-                    mp3sProcessed++;
+                MP3File mp3;
+                std::string path_utf8 = file.u8string();
+                fs::path outputFile = outputPath / filename;
+                std::string output_utf8 = outputFile.u8string();
+                if (mp3.loadTags(path_utf8.c_str())) {
+                    bool hasTag = mp3.hasID3v20() || mp3.hasID3v23() || mp3.hasID3v24();
+                    bool saved = false;
                     
-                    MP3File mp3;
-                    std::string path_utf8 = entry.path().u8string();
-                    if (mp3.load(path_utf8.c_str())) {
-                        bool hasTag = mp3.hasID3v20() || mp3.hasID3v23() || mp3.hasID3v24();
-                        
-                        if (hasTag) {
-                            ID3 id3 = mp3.getID3();
-                            id3.v2.clear();
-                            mp3.setID3(id3);
+                    if (hasTag) {
+                        ID3 id3 = mp3.getID3();
+                        id3.v2.clear();
+                        saved = mp3.saveID3(path_utf8.c_str(), id3, inPlace ? nullptr : output_utf8.c_str());
+                        if (saved) {
                             removedCount++;
-                            
-                            std::cout << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " 
-                                      << filename << " = ID3v2 removed" << std::endl;
-                        } else {
-                            std::cout << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " 
-                                      << filename << " = No ID3v2 tag (copied)" << std::endl;
                         }
                         
-                        fs::path outputFile = outputPath / filename;
-                        std::string output_utf8 = outputFile.u8string();
-                        if (!mp3.save(output_utf8.c_str())) {
-                            std::cerr << "    Failed to save: " << filename << std::endl;
-                        }
+                        std::cout << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " 
+                                  << filename << (saved ? " = ID3v2 removed" : " = Failed to remove ID3v2") << std::endl;
+                    } else if (inPlace) {
+                        saved = true;
+                        std::cout << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " 
+                                  << filename << " = No ID3v2 tag (unchanged)" << std::endl;
                     } else {
+                        File::CopyMode used = File::Copy;
+                        saved = File::copy(path_utf8.c_str(), output_utf8.c_str(), copyMode, &used);
+                        if (saved) {
+                            linked[used]++;
+                        }
                         std::cout << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " 
-                                  << filename << " = Failed to load" << std::endl;
+                                  << filename << " = No ID3v2 tag (copied)" << std::endl;
                     }
-                } else {
-                    fs::path outputFile = outputPath / filename;
-                    try {
-                        fs::copy_file(entry.path(), outputFile, fs::copy_options::overwrite_existing);
-                    } catch (const fs::filesystem_error& e) {
-                        std::cerr << "Error copying file " << filename << ": " << e.what() << std::endl;
+                    
+                    if (!saved) {
+                        std::cerr << "    Failed to save: " << filename << std::endl;
                     }
+                } else {
+                    std::cout << std::setw(3) << std::setfill('0') << mp3sProcessed << ") " 
+                              << filename << " = Failed to load" << std::endl;
+                }
+            } else if (!inPlace) {
+                std::string path_utf8 = file.u8string();
+                std::string output_utf8 = (outputPath / filename).u8string();
+                File::CopyMode used = File::Copy;
+                if (File::copy(path_utf8.c_str(), output_utf8.c_str(), copyMode, &used)) {
+                    linked[used]++;
+                } else {
+                    std::cerr << "Error copying file " << filename << std::endl;
                 }
             }
         }
     } catch (const fs::filesystem_error& e) {
         std::cerr << "Filesystem error: " << e.what() << std::endl;
-        return;
+        return false;
     }
     
     std::cout << std::string(80, '-') << std::endl;
     std::cout << "Total files: " << filesProcessed << std::endl;
     std::cout << "MP3 files: " << mp3sProcessed << std::endl;
     std::cout << "ID3v2 tags removed: " << removedCount << std::endl;
+    if (!inPlace) {
+        std::cout << "Unchanged files: " << linked[File::Reflink] << " reflinked, " << linked[File::Hardlink]
+                  << " hard-linked, " << linked[File::Copy] << " copied" << std::endl;
+    }
     std::cout << "=====================================" << std::endl;
+
+    return complete;
 }
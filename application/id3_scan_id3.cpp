@@ -4,12 +4,24 @@
  */
 
 #include <MP3File>
+#include <DirectoryWalker>
+#include <ScanCache>
+#include <RecordWriter>
 #include <iostream>
 #include <filesystem>
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -17,12 +29,40 @@
 
 namespace fs = std::filesystem;
 
+// A file to scan, numbered in directory order
+struct ScanJob {
+    int index;
+    fs::path path;
+    std::string name;
+};
+
+// The line printed for a scanned file, and the record written instead with --format
+struct ScanResult {
+    std::string line;
+    bool loaded;
+    uint64_t bytes;
+    std::string path;
+    TagProbe probe;
+    std::map<std::string, std::string> fields;
+};
+
 // Forward declarations
-bool isMp3File(const std::string& filename);
 std::string getID3Versions(const MP3File& mp3);
-void scanDirectory(const fs::path& dirPath);
+ScanResult scanFile(const ScanJob& job, ScanCache* cache, bool withFields);
+bool scanDirectory(const fs::path& dirPath, unsigned int jobs, int maxDepth, ScanCache* cache, RecordWriter* writer);
 
 int main(int argc, char* argv[]) {
+    unsigned int jobs = std::thread::hardware_concurrency();
+    if (jobs == 0) {
+        jobs = 1;
+    }
+    int maxDepth = 0;
+    bool useCache = false;
+    fs::path cachePath;
+    bool useFormat = false;
+    RecordWriter::Format format = RecordWriter::JSONLines;
+
+    std::vector<fs::path> args;
     #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
     
@@ -30,101 +70,322 @@ int main(int argc, char* argv[]) {
     LPWSTR* szArglist;
     int nArgs;
     szArglist = CommandLineToArgvW(GetCommandLineW(), &nArgs);
-    if (szArglist == NULL || nArgs < 2) {
-        std::cout << "Usage: " << argv[0] << " <directory_path>" << std::endl;
-        return 1;
+    if (szArglist != NULL) {
+        for (int i = 1; i < nArgs; i++) {
+            args.emplace_back(szArglist[i]);
+        }
+        LocalFree(szArglist);
     }
-    
-    fs::path dirPath(szArglist[1]);
-    LocalFree(szArglist);
     #else
-    if (argc < 2) {
-        std::cout << "Usage: " << argv[0] << " <directory_path>" << std::endl;
-        return 1;
+    for (int i = 1; i < argc; i++) {
+        args.emplace_back(argv[i]);
     }
-    fs::path dirPath(argv[1]);
     #endif
+
+    std::size_t argIndex = 0;
+    while (argIndex + 1 < args.size()) {
+        std::string option = args[argIndex].string();
+        if (option == "-j" && argIndex + 2 < args.size()) {
+            jobs = static_cast<unsigned int>(std::strtoul(args[argIndex + 1].string().c_str(), nullptr, 10));
+            argIndex += 2;
+        } else if (option == "--max-depth" && argIndex + 2 < args.size()) {
+            maxDepth = std::atoi(args[argIndex + 1].string().c_str());
+            argIndex += 2;
+        } else if (option == "-r") {
+            maxDepth = -1;
+            argIndex++;
+        } else if (option == "--cache") {
+            useCache = true;
+            argIndex++;
+        } else if (option == "--cache-file" && argIndex + 2 < args.size()) {
+            useCache = true;
+            cachePath = args[argIndex + 1];
+            argIndex += 2;
+        } else if (option == "--no-cache") {
+            useCache = false;
+            argIndex++;
+        } else if (option.compare(0, 9, "--format=") == 0 || (option == "--format" && argIndex + 2 < args.size())) {
+            std::string name = option == "--format" ? args[++argIndex].string() : option.substr(9);
+            if (!RecordWriter::parseFormat(name, format)) {
+                std::cerr << "Error: Unknown format " << name << ", use jsonl, csv or tsv." << std::endl;
+                return 1;
+            }
+            useFormat = true;
+            argIndex++;
+        } else {
+            break;
+        }
+    }
+    if (argIndex + 1 != args.size()) {
+        std::cout << "Usage: " << argv[0] << " [-j N] [-r] [--max-depth N] [--cache | --cache-file FILE] [--format=jsonl|csv|tsv] <directory_path>" << std::endl;
+        return 1;
+    }
+    fs::path dirPath = args[argIndex];
+
+    if (jobs == 0) {
+        std::cerr << "Error: -j needs a number of workers greater than 0." << std::endl;
+        return 1;
+    }
     
     if (!fs::exists(dirPath) || !fs::is_directory(dirPath)) {
         std::cerr << "Error: Directory does not exist." << std::endl;
         return 1;
     }
     
-    scanDirectory(dirPath);
+    // Registros para scripts vão para um buffer grande, sem flush por arquivo
+    std::unique_ptr<RecordWriter> writer;
+    if (useFormat) {
+        writer.reset(new RecordWriter(std::cout, format));
+    }
+
+    if (!useCache) {
+        return scanDirectory(dirPath, jobs, maxDepth, nullptr, writer.get()) ? 0 : 1;
+    }
+
+    // Arquivos inalterados desde o último scan são lidos do cache, custando apenas um stat
+    if (cachePath.empty()) {
+        cachePath = ScanCache::getDefaultPath(dirPath);
+    }
+    ScanCache cache;
+    cache.load(cachePath);
+
+    bool complete = scanDirectory(dirPath, jobs, maxDepth, &cache, writer.get());
+
+    if (!cache.save(cachePath)) {
+        std::cerr << "Warning: Could not write scan cache " << cachePath.string() << std::endl;
+    }
     
-    return 0;
+    return complete ? 0 : 1;
 }
 
 // Implementações
 
-bool isMp3File(const std::string& filename) {
-    if (filename.length() < 4) return false;
-    std::string ext = filename.substr(filename.length() - 4);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-    return ext == ".mp3";
+std::string getID3Versions(const MP3File& mp3) {
+    return mp3.getTagProbe().toString();
 }
 
-std::string getID3Versions(const MP3File& mp3) {
-    std::vector<std::string> versions;
-    
-    if (mp3.hasID3v10()) versions.push_back("ID3v1.0");
-    if (mp3.hasID3v11()) versions.push_back("ID3v1.1");
-    if (mp3.hasID3v20()) versions.push_back("ID3v2.0");
-    if (mp3.hasID3v23()) versions.push_back("ID3v2.3");
-    if (mp3.hasID3v24()) versions.push_back("ID3v2.4");
-    
-    if (versions.empty()) return "No ID3 tags found";
-    
-    std::string result;
-    for (size_t i = 0; i < versions.size(); ++i) {
-        result += versions[i];
-        if (i < versions.size() - 1) result += ", ";
+ScanResult scanFile(const ScanJob& job, ScanCache* cache, bool withFields) {
+    ScanResult result;
+    result.loaded = false;
+    result.bytes = 0;
+    result.path = job.path.u8string();
+
+    std::ostringstream line;
+    line << std::setw(2) << std::setfill('0') << job.index << ") " << job.name;
+
+    ScanCache::Key key;
+    ScanCache::Entry entry;
+    bool hasKey = cache != nullptr && ScanCache::getKey(job.path, key);
+    if (hasKey && cache->find(key, entry)) {
+        line << " = " << entry.probe.toString();
+        result.loaded = true;
+        result.line = line.str();
+        result.probe = entry.probe;
+        result.fields = std::move(entry.fields);
+        return result;
     }
-    
+
+    MP3File mp3;
+    // Use u8string() para garantir UTF-8 correto
+    std::string path_utf8 = job.path.u8string();
+    if (mp3.loadTags(path_utf8.c_str())) {
+        line << " = " << getID3Versions(mp3);
+        result.loaded = true;
+        // Só a cabeça e a cauda do arquivo foram lidas, não o áudio
+        result.bytes = mp3.getSize();
+
+        result.probe = mp3.getTagProbe();
+        if (hasKey || withFields) {
+            mp3.getFields(ScanCache::CORE_FIELDS, result.fields);
+        }
+        if (hasKey) {
+            entry.probe = result.probe;
+            entry.fields = result.fields;
+            cache->store(key, entry);
+        }
+    } else {
+        line << " = Failed to load";
+    }
+
+    result.line = line.str();
     return result;
 }
 
-void scanDirectory(const fs::path& dirPath) {
-    std::cout << std::endl;
-    std::cout << "====================================" << std::endl;
-    std::cout << "    ID3 Tag Scanner Application" << std::endl;
-    std::cout << "====================================" << std::endl;
-    std::cout << std::endl;
-    std::cout << "Scanning directory: " << dirPath.string() << std::endl;
-    std::cout << std::string(80, '-') << std::endl;
+bool scanDirectory(const fs::path& dirPath, unsigned int jobs, int maxDepth, ScanCache* cache, RecordWriter* writer) {
+    // With --format only records go to stdout, the summary goes to stderr
+    std::ostream& out = writer != nullptr ? std::cerr : std::cout;
+    if (writer == nullptr) {
+        std::cout << std::endl;
+        std::cout << "====================================" << std::endl;
+        std::cout << "    ID3 Tag Scanner Application" << std::endl;
+        std::cout << "====================================" << std::endl;
+        std::cout << std::endl;
+        std::cout << "Scanning directory: " << dirPath.string() << std::endl;
+        std::cout << "Workers: " << jobs << std::endl;
+        std::cout << std::string(80, '-') << std::endl;
+    }
     
     int fileCount = 0;
     int mp3Count = 0;
-    
-    try {
-        for (const auto& entry : fs::directory_iterator(dirPath)) {
-            if (entry.is_regular_file()) {
-                std::string filename = entry.path().filename().string();
-                
-                if (isMp3File(filename)) {
-                    fileCount++;
+    uint64_t totalBytes = 0;
+
+    // The directory is enumerated into a bounded queue so a huge directory is never held in memory (-r lists
+    // the tree first to number it in path order), and results are printed through a reorder buffer in that order.
+    const std::size_t queueLimit = static_cast<std::size_t>(jobs) * 16;
+    std::deque<ScanJob> queue;
+    std::map<int, ScanResult> done;
+    bool enumerated = false;
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+    std::condition_variable resultAdded;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < jobs; i++) {
+        workers.emplace_back([&]() {
+            while (true) {
+                ScanJob job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    queueChanged.wait(lock, [&]() { return !queue.empty() || enumerated; });
+                    if (queue.empty()) {
+                        return;
+                    }
+                    job = std::move(queue.front());
+                    queue.pop_front();
+                }
+                queueChanged.notify_all();
+
+                ScanResult result = scanFile(job, cache, writer != nullptr);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.emplace(job.index, std::move(result));
+                }
+                resultAdded.notify_one();
+            }
+        });
+    }
+
+    int nextToPrint = 1;
+    auto printReady = [&](std::unique_lock<std::mutex>& lock) {
+        auto it = done.find(nextToPrint);
+        while (it != done.end()) {
+            ScanResult result = std::move(it->second);
+            done.erase(it);
+            lock.unlock();
+
+            if (writer == nullptr) {
+                std::cout << result.line << '\n';
+            } else if (result.loaded) {
+                writer->write(result.path, result.probe, result.fields);
+            } else {
+                writer->writeFailure(result.path);
+            }
+            if (result.loaded) {
+                mp3Count++;
+                totalBytes += result.bytes;
+            }
+
+            lock.lock();
+            nextToPrint++;
+            it = done.find(nextToPrint);
+        }
+    };
+
+    auto enqueue = [&](const fs::path& path, const std::string& name) {
+        std::unique_lock<std::mutex> lock(mutex);
+        printReady(lock);
+        queueChanged.wait(lock, [&]() { return queue.size() < queueLimit; });
+        fileCount++;
+        queue.push_back(ScanJob{fileCount, path, name});
+        lock.unlock();
+        queueChanged.notify_all();
+    };
+
+    bool failed = false;
+    uint64_t unreadable = 0;
+    if (maxDepth != 0) {
+        // Subdirectories are listed by the shared walker first, so the files are numbered in path order whatever
+        // the walker threads did, and printed with their relative path
+        DirectoryWalker walker;
+        walker.setThreads(jobs);
+        walker.setMaxDepth(maxDepth);
+        std::vector<fs::path> files = walker.list(dirPath, [](const fs::path& file) {
+            return MP3File::isMP3File(file.filename().string());
+        });
+        if (walker.getSkippedLoops() > 0) {
+            std::cerr << "Skipped " << walker.getSkippedLoops() << " looping symbolic link(s)" << std::endl;
+        }
+        unreadable = walker.getErrors();
+        if (unreadable > 0) {
+            std::cerr << "Could not read " << unreadable << " directory(ies), their files were skipped" << std::endl;
+        }
+        for (const auto& file : files) {
+            enqueue(file, file.lexically_relative(dirPath).string());
+        }
+    } else {
+        try {
+            for (const auto& entry : fs::directory_iterator(dirPath)) {
+                if (entry.is_regular_file()) {
+                    std::string filename = entry.path().filename().string();
                     
-                    MP3File mp3;
-                    // Use u8string() para garantir UTF-8 correto
-                    std::string path_utf8 = entry.path().u8string();
-                    if (mp3.load(path_utf8.c_str())) {
-                        std::string versions = getID3Versions(mp3);
-                        std::cout << std::setw(2) << std::setfill('0') << fileCount << ") " 
-                                  << filename << " = " << versions << std::endl;
-                        mp3Count++;
-                    } else {
-                        std::cout << std::setw(2) << std::setfill('0') << fileCount << ") "
-                                  << filename << " = Failed to load" << std::endl;
+                    if (MP3File::isMP3File(filename)) {
+                        enqueue(entry.path(), filename);
                     }
                 }
             }
+        } catch (const fs::filesystem_error& e) {
+            std::cerr << "Filesystem error: " << e.what() << std::endl;
+            failed = true;
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        enumerated = true;
+        if (failed) {
+            // Stop at the error like the serial scan did, dropping the files not started yet
+            fileCount -= static_cast<int>(queue.size());
+            queue.clear();
+        }
+    }
+    queueChanged.notify_all();
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (nextToPrint <= fileCount) {
+            resultAdded.wait(lock, [&]() { return done.count(nextToPrint) != 0; });
+            printReady(lock);
         }
-    } catch (const fs::filesystem_error& e) {
-        std::cerr << "Filesystem error: " << e.what() << std::endl;
-        return;
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (writer != nullptr) {
+        writer->flush();
+    }
+
+    if (failed) {
+        return false;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (seconds <= 0) {
+        seconds = 1e-9;
     }
     
-    std::cout << std::string(80, '-') << std::endl;
-    std::cout << "Total files: " << fileCount << std::endl;
-    std::cout << "MP3 files found: " << mp3Count << std::endl;
+    out << std::string(80, '-') << std::endl;
+    out << "Total files: " << fileCount << std::endl;
+    out << "MP3 files found: " << mp3Count << std::endl;
+    out << std::fixed << std::setprecision(1) << std::setfill(' ');
+    out << "Throughput: " << fileCount / seconds << " files/s, "
+        << totalBytes / seconds / (1024.0 * 1024.0) << " MB/s read" << std::endl;
+    if (cache != nullptr) {
+        out << "Cached: " << cache->getHits() << " of " << fileCount << " files" << std::endl;
+    }
+    return unreadable == 0;
 }
@@ -0,0 +1,359 @@
+/**
+ * @file id3_watch.cpp
+ * @brief Watch a directory tree and report the ID3 tags of MP3 files as they change, using the ID3 library
+ */
+
+#include <MP3File>
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <csignal>
+    #include <cstring>
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+#ifdef __linux__
+
+using Clock = std::chrono::steady_clock;
+
+// Eventos que indicam um arquivo pronto (escrito e fechado, ou movido para dentro) ou removido
+static const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE | IN_DELETE_SELF;
+
+// Directory watches of the tree and the files waiting for their debounce window to end
+struct Watcher {
+    int inotify;
+    fs::path root;
+    std::map<int, fs::path> directories;
+    std::map<fs::path, Clock::time_point> pending;
+    std::chrono::milliseconds debounce;
+};
+
+// Where change records are written: stdout, or every client of a local Unix socket
+struct Output {
+    int listener;
+    std::vector<int> clients;
+};
+
+static volatile std::sig_atomic_t stopRequested = 0;
+
+// Forward declarations
+void addWatches(Watcher& watcher, const fs::path& root, bool queueFiles);
+void removeWatches(Watcher& watcher, const fs::path& root);
+void readEvents(Watcher& watcher, Output& output);
+void probeReady(Watcher& watcher, Output& output);
+void emit(Output& output, const std::string& record);
+int openSocket(const fs::path& socketPath);
+void acceptClients(Output& output);
+void onSignal(int signal);
+
+int main(int argc, char* argv[]) {
+    std::chrono::milliseconds debounce(500);
+    fs::path socketPath;
+
+    int argIndex = 1;
+    while (argIndex + 1 < argc) {
+        std::string option = argv[argIndex];
+        if (option == "--debounce" && argIndex + 2 < argc) {
+            debounce = std::chrono::milliseconds(std::strtoul(argv[argIndex + 1], nullptr, 10));
+            argIndex += 2;
+        } else if (option == "--socket" && argIndex + 2 < argc) {
+            socketPath = argv[argIndex + 1];
+            argIndex += 2;
+        } else {
+            break;
+        }
+    }
+    if (argIndex + 1 != argc) {
+        std::cout << "Usage: " << argv[0] << " [--debounce MS] [--socket PATH] <directory_path>" << std::endl;
+        return 1;
+    }
+    fs::path dirPath = argv[argIndex];
+
+    if (!fs::exists(dirPath) || !fs::is_directory(dirPath)) {
+        std::cerr << "Error: Directory does not exist." << std::endl;
+        return 1;
+    }
+
+    Watcher watcher;
+    watcher.root = dirPath;
+    watcher.debounce = debounce;
+    watcher.inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher.inotify < 0) {
+        std::cerr << "Error: Could not initialize inotify: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    Output output;
+    output.listener = -1;
+    if (!socketPath.empty()) {
+        output.listener = openSocket(socketPath);
+        if (output.listener < 0) {
+            std::cerr << "Error: Could not listen on " << socketPath.string() << ": " << std::strerror(errno) << std::endl;
+            close(watcher.inotify);
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    addWatches(watcher, dirPath, false);
+    std::cerr << "Watching " << watcher.directories.size() << " director" << (watcher.directories.size() == 1 ? "y" : "ies")
+              << " under " << dirPath.string() << std::endl;
+
+    while (!stopRequested) {
+        // Sleep until an event arrives or the earliest debounce window ends
+        int timeout = -1;
+        if (!watcher.pending.empty()) {
+            auto earliest = watcher.pending.begin()->second;
+            for (const auto& item : watcher.pending) {
+                earliest = std::min(earliest, item.second);
+            }
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(earliest - Clock::now()).count();
+            timeout = wait > 0 ? static_cast<int>(wait) + 1 : 0;
+        }
+
+        struct pollfd descriptors[2];
+        descriptors[0].fd = watcher.inotify;
+        descriptors[0].events = POLLIN;
+        descriptors[1].fd = output.listener;
+        descriptors[1].events = POLLIN;
+        int count = poll(descriptors, output.listener >= 0 ? 2 : 1, timeout);
+        if (count < 0 && errno != EINTR) {
+            std::cerr << "Error: poll failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        if (count > 0 && (descriptors[0].revents & POLLIN) != 0) {
+            readEvents(watcher, output);
+        }
+        if (count > 0 && output.listener >= 0 && (descriptors[1].revents & POLLIN) != 0) {
+            acceptClients(output);
+        }
+        probeReady(watcher, output);
+    }
+
+    for (int client : output.clients) {
+        close(client);
+    }
+    if (output.listener >= 0) {
+        close(output.listener);
+        unlink(socketPath.c_str());
+    }
+    close(watcher.inotify);
+
+    return 0;
+}
+
+// Implementações
+
+void onSignal(int) {
+    stopRequested = 1;
+}
+
+void addWatches(Watcher& watcher, const fs::path& root, bool queueFiles) {
+    std::vector<fs::path> directories{root};
+    while (!directories.empty()) {
+        fs::path directory = directories.back();
+        directories.pop_back();
+
+        int watch = inotify_add_watch(watcher.inotify, directory.c_str(), WATCH_MASK | IN_ONLYDIR);
+        if (watch < 0) {
+            std::cerr << "Warning: Could not watch " << directory.string() << ": " << std::strerror(errno) << std::endl;
+            continue;
+        }
+        watcher.directories[watch] = directory;
+
+        // Symbolic links are not followed, so a link loop can not add watches forever
+        std::error_code error;
+        for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+            if (it->is_symlink(error)) {
+                continue;
+            }
+            if (it->is_directory(error)) {
+                directories.push_back(it->path());
+            } else if (queueFiles && it->is_regular_file(error) && MP3File::isMP3File(it->path().filename().string())) {
+                // Files written into a new directory before its watch existed would be missed otherwise
+                watcher.pending[it->path()] = Clock::now() + watcher.debounce;
+            }
+        }
+    }
+}
+
+void removeWatches(Watcher& watcher, const fs::path& root) {
+    // The watches of a directory moved out of the tree stay valid, under paths that are no longer there
+    auto isUnderRoot = [&root](const fs::path& path) {
+        return std::mismatch(root.begin(), root.end(), path.begin(), path.end()).first == root.end();
+    };
+    for (auto it = watcher.directories.begin(); it != watcher.directories.end(); ) {
+        if (isUnderRoot(it->second)) {
+            inotify_rm_watch(watcher.inotify, it->first);
+            it = watcher.directories.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = watcher.pending.begin(); it != watcher.pending.end(); ) {
+        it = isUnderRoot(it->first) ? watcher.pending.erase(it) : std::next(it);
+    }
+}
+
+void readEvents(Watcher& watcher, Output& output) {
+    alignas(struct inotify_event) char buffer[64 * 1024];
+
+    while (true) {
+        ssize_t length = read(watcher.inotify, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return;
+        }
+
+        for (char* position = buffer; position < buffer + length; ) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(position);
+            position += sizeof(struct inotify_event) + event->len;
+
+            if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                // Events were lost, probe every file of the tree again
+                std::cerr << "Warning: inotify queue overflow, rescanning" << std::endl;
+                for (const auto& item : watcher.directories) {
+                    inotify_rm_watch(watcher.inotify, item.first);
+                }
+                watcher.directories.clear();
+                addWatches(watcher, watcher.root, true);
+                continue;
+            }
+
+            auto directory = watcher.directories.find(event->wd);
+            if (directory == watcher.directories.end()) {
+                continue;
+            }
+            if ((event->mask & (IN_IGNORED | IN_DELETE_SELF)) != 0) {
+                watcher.directories.erase(directory);
+                continue;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+
+            fs::path path = directory->second / event->name;
+            if ((event->mask & IN_ISDIR) != 0) {
+                if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+                    addWatches(watcher, path, true);
+                } else if ((event->mask & IN_MOVED_FROM) != 0) {
+                    // Moved within the tree it is watched again from its IN_MOVED_TO, under the new path
+                    removeWatches(watcher, path);
+                }
+                continue;
+            }
+            if (!MP3File::isMP3File(event->name)) {
+                continue;
+            }
+
+            if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0) {
+                // A burst of writes to the same file only pushes its deadline, it is probed once
+                watcher.pending[path] = Clock::now() + watcher.debounce;
+            } else if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+                watcher.pending.erase(path);
+                emit(output, "removed\t" + path.string());
+            }
+        }
+    }
+}
+
+void probeReady(Watcher& watcher, Output& output) {
+    auto now = Clock::now();
+    for (auto it = watcher.pending.begin(); it != watcher.pending.end(); ) {
+        if (it->second > now) {
+            ++it;
+            continue;
+        }
+
+        MP3File mp3;
+        std::string path_utf8 = it->first.u8string();
+        if (mp3.loadTags(path_utf8.c_str())) {
+            emit(output, "changed\t" + it->first.string() + "\t" + mp3.getTagProbe().toString());
+        } else if (fs::exists(it->first)) {
+            emit(output, "failed\t" + it->first.string());
+        }
+        it = watcher.pending.erase(it);
+    }
+}
+
+void emit(Output& output, const std::string& record) {
+    if (output.listener < 0) {
+        std::cout << record << std::endl;
+        return;
+    }
+
+    std::string line = record + "\n";
+    for (auto it = output.clients.begin(); it != output.clients.end(); ) {
+        // A client too slow to take a whole record is dropped rather than blocking the watch
+        if (send(*it, line.data(), line.size(), MSG_NOSIGNAL | MSG_DONTWAIT) != static_cast<ssize_t>(line.size())) {
+            close(*it);
+            it = output.clients.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int openSocket(const fs::path& socketPath) {
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.string().size() >= sizeof(address.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0) {
+        return -1;
+    }
+
+    // A socket left by a previous run is replaced
+    unlink(socketPath.c_str());
+    if (bind(listener, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 16) != 0) {
+        int error = errno;
+        close(listener);
+        errno = error;
+        return -1;
+    }
+
+    return listener;
+}
+
+void acceptClients(Output& output) {
+    while (true) {
+        int client = accept4(output.listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            return;
+        }
+        output.clients.push_back(client);
+    }
+}
+
+#else
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    std::cerr << "Error: " << argv[0] << " needs inotify and only runs on Linux." << std::endl;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,251 @@
+#include "DirectoryWalker.hpp"
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+
+#ifndef _WIN32
+	#include <sys/stat.h>
+#endif
+
+DirectoryWalker::DirectoryWalker() :
+	threads(0), maxDepth(-1), pending(0), queued(0), skippedLoops(0), errors(0), stopped(false){
+
+}
+
+DirectoryWalker::~DirectoryWalker(){
+
+}
+
+void DirectoryWalker::setThreads(unsigned int threads){
+	this->threads = threads;
+}
+
+void DirectoryWalker::setMaxDepth(int maxDepth){
+	this->maxDepth = maxDepth;
+}
+
+bool DirectoryWalker::visit(const std::filesystem::path& root, const std::function<void(const std::filesystem::path&)>& visitor){
+	skippedLoops = 0;
+	errors = 0;
+	stopped = false;
+	failure = nullptr;
+
+	std::error_code error;
+	if(std::filesystem::is_directory(root, error) == false){
+		return false;
+	}
+
+	Directory first;
+	first.path = root;
+	first.depth = 0;
+	DirectoryId id;
+	if(getDirectoryId(root, id) == true){
+		first.ancestors.push_back(id);
+	}
+
+	unsigned int count = threads;
+	if(count == 0){
+		count = std::thread::hardware_concurrency();
+	}
+	if(count == 0){
+		count = 1;
+	}
+
+	workers.clear();
+	for(unsigned int i = 0; i < count; i++){
+		workers.push_back(std::unique_ptr<Worker>(new Worker()));
+	}
+	workers[0]->directories.push_back(first);
+	pending = 1;
+	queued = 1;
+
+	auto work = [this, &visitor](std::size_t self){
+		Directory directory;
+		while(true){
+			if(take(self, directory) == true){
+				// The directories left are still taken to count them down, but no longer listed
+				try{
+					listDirectory(self, directory, visitor);
+				}catch(...){
+					std::lock_guard<std::mutex> lock(idleMutex);
+					if(failure == nullptr){
+						failure = std::current_exception();
+					}
+					stopped = true;
+				}
+				if(--pending == 0){
+					std::lock_guard<std::mutex> lock(idleMutex);
+					idle.notify_all();
+				}
+				continue;
+			}
+
+			// Nothing to take: sleep until another worker pushes a directory or the last one is listed
+			std::unique_lock<std::mutex> lock(idleMutex);
+			idle.wait(lock, [this](){
+				return pending == 0 || queued > 0;
+			});
+			if(pending == 0){
+				return;
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for(std::size_t i = 1; i < workers.size(); i++){
+		pool.emplace_back(work, i);
+	}
+	work(0);
+	for(auto& thread : pool){
+		thread.join();
+	}
+
+	workers.clear();
+
+	if(failure != nullptr){
+		std::exception_ptr thrown = failure;
+		failure = nullptr;
+		std::rethrow_exception(thrown);
+	}
+
+	return true;
+}
+
+std::vector<std::filesystem::path> DirectoryWalker::list(const std::filesystem::path& root, const std::function<bool(const std::filesystem::path&)>& filter){
+	std::vector<std::filesystem::path> files;
+	std::mutex mutex;
+
+	visit(root, [&](const std::filesystem::path& file){
+		if(filter == nullptr || filter(file) == true){
+			std::lock_guard<std::mutex> lock(mutex);
+			files.push_back(file);
+		}
+	});
+
+	std::sort(files.begin(), files.end());
+
+	return files;
+}
+
+uint64_t DirectoryWalker::getSkippedLoops() const{
+	return skippedLoops;
+}
+
+uint64_t DirectoryWalker::getErrors() const{
+	return errors;
+}
+
+bool DirectoryWalker::take(std::size_t self, Directory& directory){
+	{
+		Worker& own = *workers[self];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if(own.directories.empty() == false){
+			directory = std::move(own.directories.back());
+			own.directories.pop_back();
+			queued--;
+			return true;
+		}
+	}
+
+	for(std::size_t i = 1; i < workers.size(); i++){
+		Worker& victim = *workers[(self + i) % workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if(victim.directories.empty() == false){
+			directory = std::move(victim.directories.front());
+			victim.directories.pop_front();
+			queued--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void DirectoryWalker::listDirectory(std::size_t self, const Directory& directory, const std::function<void(const std::filesystem::path&)>& visitor){
+	if(stopped == true){
+		return;
+	}
+
+	std::error_code error;
+	std::filesystem::directory_iterator iterator(directory.path, error);
+	if(error){
+		errors++;
+		return;
+	}
+
+	std::vector<Directory> subdirectories;
+	for(std::filesystem::directory_iterator end; iterator != end; iterator.increment(error)){
+		const std::filesystem::directory_entry& entry = *iterator;
+
+		std::error_code status;
+		if(entry.is_regular_file(status) == true){
+			visitor(entry.path());
+			continue;
+		}
+
+		if(entry.is_directory(status) == false || (maxDepth >= 0 && directory.depth >= maxDepth)){
+			continue;
+		}
+
+		Directory subdirectory;
+		subdirectory.path = entry.path();
+		subdirectory.depth = directory.depth + 1;
+		subdirectory.ancestors = directory.ancestors;
+
+		DirectoryId id;
+		if(getDirectoryId(entry.path(), id) == true){
+			// A link back to a directory being walked, or a bind mount of it, would never end
+			bool loops = std::any_of(directory.ancestors.begin(), directory.ancestors.end(), [&id](const DirectoryId& ancestor){
+				return ancestor.device == id.device && ancestor.inode == id.inode;
+			});
+			if(loops == true){
+				skippedLoops++;
+				continue;
+			}
+			subdirectory.ancestors.push_back(id);
+		}
+
+		subdirectories.push_back(std::move(subdirectory));
+	}
+	if(error){
+		errors++;
+	}
+
+	if(subdirectories.empty() == false){
+		pending += subdirectories.size();
+
+		{
+			Worker& own = *workers[self];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			for(auto& subdirectory : subdirectories){
+				own.directories.push_back(std::move(subdirectory));
+			}
+			queued += subdirectories.size();
+		}
+
+		std::lock_guard<std::mutex> lock(idleMutex);
+		idle.notify_all();
+	}
+}
+
+bool DirectoryWalker::getDirectoryId(const std::filesystem::path& path, DirectoryId& id){
+#ifndef _WIN32
+	struct stat status;
+	if(stat(path.c_str(), &status) != 0){
+		return false;
+	}
+	id.device = static_cast<uint64_t>(status.st_dev);
+	id.inode = static_cast<uint64_t>(status.st_ino);
+	return true;
+#else
+	std::error_code error;
+	std::filesystem::path canonical = std::filesystem::canonical(path, error);
+	if(error){
+		return false;
+	}
+	id.device = 0;
+	id.inode = static_cast<uint64_t>(std::filesystem::hash_value(canonical));
+	return true;
+#endif
+}
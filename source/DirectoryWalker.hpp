@@ -0,0 +1,152 @@
+#ifndef DIRECTORYWALKER_HPP
+#define DIRECTORYWALKER_HPP
+
+/**
+ * @file DirectoryWalker.hpp
+ *
+ * @author Evandro L. Vieira
+ *
+ * @brief This file contains the definition of the class DirectoryWalker.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class DirectoryWalker
+ *
+ * @brief Recursive directory traversal spread over worker threads by work stealing.
+ *
+ * Each worker owns a deque of directories: it lists the newest one it pushed and, when its deque is empty,
+ * steals the oldest directory of another worker, so wide and deeply nested trees keep all workers busy. A worker
+ * with nothing to take sleeps until a directory is pushed or the walk ends.
+ * Symbolic links to directories are followed unless they point back to a directory being walked, which would loop.
+ */
+class DirectoryWalker{
+	public:
+		/**
+		 * @brief Default constructor, one worker per core and no depth limit.
+		 */
+		DirectoryWalker();
+
+		/**
+		 * @brief Default virtual destructor.
+		 */
+		virtual ~DirectoryWalker();
+
+		/**
+		 * @brief Set the number of worker threads.
+		 *
+		 * @param threads Number of workers, 0 for one per core.
+		 */
+		void setThreads(unsigned int threads);
+
+		/**
+		 * @brief Set how deep subdirectories are walked.
+		 *
+		 * @param maxDepth 0 lists only the root directory, 1 also its subdirectories and so on, negative for no limit.
+		 */
+		void setMaxDepth(int maxDepth);
+
+		/**
+		 * @brief Call the visitor for every regular file under root.
+		 *
+		 * @param root The directory to walk.
+		 * @param visitor Called from the worker threads, concurrently, with the path of each regular file.
+		 *
+		 * @return true if root is a directory, false otherwise.
+		 *
+		 * @throw The first exception thrown by the visitor, once the workers stopped. No directory is listed after it.
+		 */
+		bool visit(const std::filesystem::path& root, const std::function<void(const std::filesystem::path&)>& visitor);
+
+		/**
+		 * @brief List the regular files under root.
+		 *
+		 * @param root The directory to walk.
+		 * @param filter Called from the worker threads with the path of each regular file, the file is listed if it returns true. nullptr lists all files.
+		 *
+		 * @return The paths, sorted so the order does not depend on the workers.
+		 *
+		 * @throw The first exception thrown by the filter, see visit().
+		 */
+		std::vector<std::filesystem::path> list(const std::filesystem::path& root, const std::function<bool(const std::filesystem::path&)>& filter = nullptr);
+
+		/**
+		 * @brief Get the number of symbolic links skipped by the last walk because they loop.
+		 *
+		 * @return The number of links skipped.
+		 */
+		uint64_t getSkippedLoops() const;
+
+		/**
+		 * @brief Get the number of directories the last walk could not list.
+		 *
+		 * @return The number of directories.
+		 */
+		uint64_t getErrors() const;
+
+	private:
+		/**
+		 * @brief Identity of a directory, device and inode on POSIX systems.
+		 */
+		struct DirectoryId{
+			uint64_t device;	///< Device of the directory.
+			uint64_t inode;		///< Inode of the directory, a hash of its canonical path on Windows.
+		};
+
+		/**
+		 * @brief A directory waiting to be listed.
+		 */
+		struct Directory{
+			std::filesystem::path path;			///< Path of the directory.
+			int depth;							///< Depth below root, 0 for root.
+			std::vector<DirectoryId> ancestors;	///< Identities of the directories from root down to this one, included.
+		};
+
+		/**
+		 * @brief Directories owned by a worker.
+		 */
+		struct Worker{
+			std::mutex mutex;						///< Guards directories.
+			std::deque<Directory> directories;		///< Directories to list, the owner takes from the back, thieves from the front.
+		};
+
+		/**
+		 * @brief Take the next directory for the given worker, its own newest or the oldest of another worker.
+		 */
+		bool take(std::size_t self, Directory& directory);
+
+		/**
+		 * @brief List one directory, visiting its files and pushing its subdirectories to the given worker.
+		 */
+		void listDirectory(std::size_t self, const Directory& directory, const std::function<void(const std::filesystem::path&)>& visitor);
+
+		/**
+		 * @brief Get the identity of a directory.
+		 */
+		static bool getDirectoryId(const std::filesystem::path& path, DirectoryId& id);
+
+	private:
+		unsigned int threads;	///< Number of workers, 0 for one per core.
+		int maxDepth;			///< Depth limit, negative for none.
+		std::vector<std::unique_ptr<Worker>> workers;	///< Workers of the current walk.
+		std::atomic<uint64_t> pending;		///< Directories pushed and not listed yet.
+		std::atomic<uint64_t> queued;		///< Directories pushed and not taken yet.
+		std::mutex idleMutex;				///< Guards the waits on idle.
+		std::condition_variable idle;		///< Notified when directories are pushed and when pending reaches 0.
+		std::atomic<uint64_t> skippedLoops;	///< Symbolic links skipped because they loop.
+		std::atomic<uint64_t> errors;		///< Directories that could not be listed.
+		std::atomic<bool> stopped;			///< Whether the visitor threw, no more directories are listed.
+		std::exception_ptr failure;			///< First exception thrown by the visitor, guarded by idleMutex.
+};
+
+#endif /* DIRECTORYWALKER_HPP */
@@ -1,10 +1,80 @@
 #include "File.hpp"
 
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#ifdef __linux__
+	#include <linux/fs.h>
+	#include <sys/ioctl.h>
+#endif
+
+/**
+ * @brief Replace target by a reflink of source, sharing its blocks, false when the file system can not.
+ */
+static bool reflinkFile(const char* source, const char* target){
+#if defined(__linux__) && defined(FICLONE)
+	int input = open(source, O_RDONLY | O_CLOEXEC);
+	if(input < 0){
+		return false;
+	}
+
+	struct stat status;
+	if(fstat(input, &status) != 0){
+		close(input);
+		return false;
+	}
+
+	int output = open(target, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, status.st_mode & 0777);
+	if(output < 0){
+		close(input);
+		return false;
+	}
+
+	bool cloned = ioctl(output, FICLONE, input) == 0;
+	close(output);
+	close(input);
+	if(cloned == false){
+		unlink(target);
+	}
+	return cloned;
+#else
+	(void)source;
+	(void)target;
+	return false;
+#endif
+}
+
+/**
+ * @brief Flush the written content of the given file to disk.
+ */
+static bool syncFile(const char* filename){
+#ifndef _WIN32
+	int descriptor = open(filename, O_RDONLY | O_CLOEXEC);
+	if(descriptor < 0){
+		return false;
+	}
+	bool success = fsync(descriptor) == 0;
+	close(descriptor);
+	return success;
+#else
+	(void)filename;
+	return true;
+#endif
+}
 
 File::File() :
-	data(nullptr), size(0){
+	data(nullptr), size(0), mapped(false){
 
 }
 
@@ -14,10 +84,19 @@ File::~File(){
 
 void File::clear(){
 	if(data != nullptr){
+#ifndef _WIN32
+		if(mapped == true){
+			munmap(data, static_cast<std::size_t>(size));
+		}else{
+			delete[] data;
+		}
+#else
 		delete[] data;
+#endif
 		data = nullptr;
 	}
 	size = 0;
+	mapped = false;
 }
 
 bool File::isEmpty() const{
@@ -28,6 +107,14 @@ bool File::isEmpty() const{
 	}
 }
 
+bool File::isMapped() const{
+	return mapped;
+}
+
+uint64_t File::getSize() const{
+	return size;
+}
+
 uint8_t& File::operator[](uint64_t index) {
 	if(index >= size){
 		throw std::out_of_range("Index out of range");
@@ -36,11 +123,15 @@ uint8_t& File::operator[](uint64_t index) {
 	}
 }
 
-bool File::load(const char *filename){
+bool File::load(const char *filename, LoadMode mode, AccessHint hint){
 	if(isEmpty() == false){
 		return false;
 	}
 
+	if(mode == Mapped && map(filename, hint) == true){
+		return true;
+	}
+
 	std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
 	if(file.is_open() == false){
 		return false;
@@ -69,21 +160,190 @@ bool File::load(const char *filename){
 	return true;
 }
 
+bool File::map(const char* filename, AccessHint hint){
+#ifndef _WIN32
+	int descriptor = open(filename, O_RDONLY);
+	if(descriptor < 0){
+		return false;
+	}
+
+	struct stat status;
+	if(fstat(descriptor, &status) != 0 || status.st_size <= 0){
+		close(descriptor);
+		return false;
+	}
+
+	std::size_t fileSize = static_cast<std::size_t>(status.st_size);
+
+	// MAP_PRIVATE gives copy-on-write pages, so File::operator[] can still be written without touching the file.
+	void* address = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+	if(address == MAP_FAILED){
+		return false;
+	}
+
+	// Reading only the tags at the head and tail should not read ahead the audio in between, copying it should read ahead more.
+	if(hint != Normal){
+		madvise(address, fileSize, hint == Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+	}
+
+	data = static_cast<uint8_t*>(address);
+	size = static_cast<uint64_t>(fileSize);
+	mapped = true;
+
+	return true;
+#else
+	(void)filename;
+	(void)hint;
+	return false;
+#endif
+}
+
 bool File::save(const char* filename){
 	if(isEmpty() == true){
 		return false;
 	}
 
-	std::ofstream file(filename, std::ios::out | std::ios::binary);
+	return saveRange(filename, 0, size);
+}
+
+bool File::saveRange(const char* filename, uint64_t offset, uint64_t length) const{
+	if(isEmpty() == true || offset > size || length > size - offset){
+		return false;
+	}
+
+	// A mapped file can be the save target itself, truncating it would invalidate File::data.
+	std::string output(filename);
+	std::error_code error;
+	bool replace = mapped == true && std::filesystem::exists(filename, error) == true;
+	if(replace == true){
+		if(createTemporary(filename, output) == false){
+			return false;
+		}
+#ifndef _WIN32
+		struct stat status;
+		if(stat(filename, &status) == 0){
+			chmod(output.c_str(), status.st_mode & 07777);
+		}
+#endif
+	}
+
+	std::ofstream file(output.c_str(), std::ios::out | std::ios::binary);
 	if(file.is_open() == false){
+		if(replace == true){
+			std::remove(output.c_str());
+		}
 		return false;
 	}
 
-	file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+	file.write(reinterpret_cast<const char*>(&data[offset]), static_cast<std::streamsize>(length));
+	file.close();
 	if(file.fail() == true){
+		if(replace == true){
+			std::remove(output.c_str());
+		}
+		return false;
+	}
+
+	if(replace == true){
+		//the new content must be on disk before the rename makes it visible, and the rename must reach the directory
+		if(syncFile(output.c_str()) == false){
+			std::remove(output.c_str());
+			return false;
+		}
+		std::filesystem::rename(output, filename, error);
+		if(error){
+			std::remove(output.c_str());
+			return false;
+		}
+		syncParentDirectory(filename);
+	}
+
+	return true;
+}
+
+bool File::copy(const char* source, const char* target, CopyMode mode, CopyMode* used){
+	// The old target is unlinked first, truncating it would also truncate the source if it is a hard link of it
+	std::error_code error;
+	std::filesystem::remove(target, error);
+
+	if(mode == Hardlink){
+		// A link fails across file systems, where a reflink or copy still works
+		std::filesystem::create_hard_link(source, target, error);
+		if(!error){
+			if(used != nullptr){
+				*used = Hardlink;
+			}
+			return true;
+		}
+	}
+
+	if(mode != Copy && reflinkFile(source, target) == true){
+		if(used != nullptr){
+			*used = Reflink;
+		}
+		return true;
+	}
+
+	if(std::filesystem::copy_file(source, target, std::filesystem::copy_options::overwrite_existing, error) == false){
+		return false;
+	}
+	if(used != nullptr){
+		*used = Copy;
+	}
+	return true;
+}
+
+bool File::createTemporary(const char* target, std::string& temporary){
+#ifndef _WIN32
+	temporary = std::string(target) + ".XXXXXX";
+	int descriptor = mkstemp(&temporary[0]);
+	if(descriptor < 0){
 		return false;
 	}
+	close(descriptor);
+	return true;
+#else
+	for(int attempt = 0; attempt < 100; attempt++){
+		temporary = std::string(target) + ".tmp" + (attempt > 0 ? std::to_string(attempt) : std::string());
+		std::error_code error;
+		if(std::filesystem::exists(temporary, error) == false && !error){
+			std::ofstream file(temporary.c_str(), std::ios::out | std::ios::binary);
+			return file.is_open();
+		}
+	}
+	return false;
+#endif
+}
+
+bool File::syncParentDirectory(const char* filename){
+#ifndef _WIN32
+	std::string path(filename);
+	std::size_t slash = path.find_last_of('/');
+	std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
 
+	int descriptor = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if(descriptor < 0){
+		return false;
+	}
+	bool success = fsync(descriptor) == 0;
+	close(descriptor);
+	return success;
+#else
+	(void)filename;
 	return true;
+#endif
 }
 
+bool File::parseCopyMode(const std::string& name, CopyMode& mode){
+	if(name == "copy"){
+		mode = Copy;
+	}else if(name == "reflink"){
+		mode = Reflink;
+	}else if(name == "hardlink"){
+		mode = Hardlink;
+	}else{
+		return false;
+	}
+	return true;
+}
@@ -10,14 +10,50 @@
  */
 
 #include <cstdint>
+#include <string>
 
 /**
  * @brief File class that holds binary data.
+ *
+ * @note The data can be backed by a heap buffer (File::Heap) or by a private memory mapping of the file (File::Mapped).
+ *       Both modes expose the same File::data and File::size view.
  */
 class File{
 	friend class MP3File;
 
 	public:
+		/**
+		 * @enum File::LoadMode
+		 *
+		 * @brief How File::load() makes the file content available in File::data.
+		 */
+		enum LoadMode{
+			Heap = 0,	/**< Allocate a buffer and read the whole file into it. */
+			Mapped = 1	/**< Map the file copy-on-write, only the touched pages are read. Falls back to File::Heap when mapping is not available. */
+		};
+
+		/**
+		 * @enum File::AccessHint
+		 *
+		 * @brief How a File::Mapped file will be read, given to the kernel to tune its read-ahead.
+		 */
+		enum AccessHint{
+			Normal = 0,		/**< No hint, the default read-ahead. */
+			Sequential = 1,	/**< The file is read from start to end once, such as copied or indexed frame by frame. */
+			Random = 2		/**< Only a few ranges are read, such as the tags at the head and tail, so nothing is read ahead. */
+		};
+
+		/**
+		 * @enum File::CopyMode
+		 *
+		 * @brief How File::copy() puts the bytes of a file at another path.
+		 */
+		enum CopyMode{
+			Copy = 0,		/**< Read and write all bytes. */
+			Reflink = 1,	/**< Share the blocks of the source (FICLONE), the copy is independent but costs only metadata. Falls back to File::Copy when the file system can not. */
+			Hardlink = 2	/**< Add another name to the source file, changes to one are seen in the other. Falls back to File::Reflink across file systems. */
+		};
+
 		/**
 		 * @brief Default constructor that initializes the object with empty data.
 		 */
@@ -36,13 +72,15 @@ class File{
 		 * @return A reference to the byte at the given index in File::data.
 		 *
 		 * @throws std::out_of_range If the index is out of bounds (index >= size).
+		 *
+		 * @note Writing to a mapped file only changes the private copy of the page, never the file on disk.
 		 */
 		uint8_t& operator[](uint64_t index);
 
 		/**
 		 * @brief Function that releases all data, clears the content of File::data and sets size to 0.
 		 */
-		void clear();
+		virtual void clear();
 
 		/**
 		 * @brief Check if data is empty.
@@ -51,14 +89,30 @@ class File{
 		 */
 		bool isEmpty() const;
 
+		/**
+		 * @brief Check if File::data is a memory mapping of the loaded file.
+		 *
+		 * @return true if mapped, false if heap allocated or empty.
+		 */
+		bool isMapped() const;
+
+		/**
+		 * @brief Get the number of bytes in File::data.
+		 *
+		 * @return The size of File::data, only the bytes read at the head and tail after MP3File::loadTags().
+		 */
+		uint64_t getSize() const;
+
 		/**
 		 * @brief Load data from file and store into File::data if File::data is empty.
 		 *
 		 * @param file The file path to load data from.
+		 * @param mode File::Heap to copy the file into memory or File::Mapped to map it.
+		 * @param hint How a mapped file will be read, ignored for File::Heap.
 		 *
 		 * @return true if successful, false otherwise.
 		 */
-		bool load(const char* file);
+		bool load(const char* file, LoadMode mode = Heap, AccessHint hint = Normal);
 
 		/**
 		 * @brief Write data into the given file.
@@ -66,12 +120,81 @@ class File{
 		 * @param file The file path to save data to.
 		 *
 		 * @return true if successful, false otherwise.
+		 *
+		 * @note When File::data is mapped, the data is written to a temporary file that is then renamed over an existing
+		 *       target with its permissions, so saving over the file that is currently mapped is safe.
 		 */
 		bool save(const char* file);
 
+		/**
+		 * @brief Write part of data into the given file, leaving data unchanged.
+		 *
+		 * @param file The file path to save to.
+		 * @param offset Offset in data of the first byte to write.
+		 * @param length Number of bytes to write.
+		 *
+		 * @return true if successful, false otherwise or if the range is not inside data.
+		 *
+		 * @note Saving over the mapped file is safe, as with save().
+		 */
+		bool saveRange(const char* file, uint64_t offset, uint64_t length) const;
+
+		/**
+		 * @brief Put the bytes of a file at another path, replacing what is there.
+		 *
+		 * @param source The file path to copy.
+		 * @param target The file path to create or replace.
+		 * @param mode The preferred way, weaker ones are tried when it is not possible.
+		 * @param used Set to the way the copy was made when not nullptr.
+		 *
+		 * @return true if successful, false otherwise.
+		 */
+		static bool copy(const char* source, const char* target, CopyMode mode, CopyMode* used = nullptr);
+
+		/**
+		 * @brief Get the copy mode of the given name.
+		 *
+		 * @param name "copy", "reflink" or "hardlink".
+		 * @param mode Set to the mode when the name is known.
+		 *
+		 * @return true if known, false otherwise.
+		 */
+		static bool parseCopyMode(const std::string& name, CopyMode& mode);
+
+		/**
+		 * @brief Create a new empty file next to target, to be renamed over it once written.
+		 *
+		 * @param target The file path the temporary file will replace.
+		 * @param temporary Set to the path of the file created, never an existing file.
+		 *
+		 * @return true if successful, false otherwise.
+		 */
+		static bool createTemporary(const char* target, std::string& temporary);
+
+		/**
+		 * @brief Flush the directory holding the given file, so a rename into it survives a crash.
+		 *
+		 * @param file The file path whose directory is flushed.
+		 *
+		 * @return true if successful, false otherwise.
+		 */
+		static bool syncParentDirectory(const char* file);
+
+	private:
+		/**
+		 * @brief Map the given file copy-on-write into File::data.
+		 *
+		 * @param file The file path to map.
+		 * @param hint How the mapping will be read.
+		 *
+		 * @return true if successful, false otherwise.
+		 */
+		bool map(const char* file, AccessHint hint);
+
 	private:
 		uint8_t* data;	///< Pointer to the array holding the binary data.
 		uint64_t size;	///< The size of the data array.
+		bool mapped;	///< Whether File::data is a memory mapping instead of a heap buffer.
 };
 
 #endif /* FILE_HPP */
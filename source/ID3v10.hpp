@@ -75,6 +75,7 @@ struct ID3v10Data{
  */
 class ID3v10{
 	friend class MP3File;
+	friend class TagConverter;
 
 	public:
 		/**
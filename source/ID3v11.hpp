@@ -84,6 +84,7 @@ struct ID3v11Data{
  */
 class ID3v11{
 	friend class MP3File;
+	friend class TagConverter;
 
 	public:
 		/**
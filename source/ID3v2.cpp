@@ -77,6 +77,14 @@ bool ID3v2::isV24() const{
 	return v24 != nullptr;
 }
 
+uint8_t ID3v2::getVersion() const{
+	if(v20 == nullptr){
+		return 0;
+	}
+
+	return v20->header.major_version;
+}
+
 void ID3v2::clear(){
 	if(v20 != nullptr){
 		delete v20;
@@ -153,6 +153,16 @@ union ID3v2{
 		 */
 		bool isV24() const;
 
+		/**
+		 * @brief: Get the major version of the held tag.
+		 *
+		 * @return: 2, 3 or 4 for ID3v20, ID3v23 or ID3v24, 0 if no tag is held.
+		 *
+		 * @note All members share the same storage, so isV20(), isV23() and isV24() can not tell them apart.
+		 *       Every version keeps its header as first member, so the major version is read from there.
+		 */
+		uint8_t getVersion() const;
+
 		/**
 		 * @brief: Deallocate ID3v20::v20, ID3v23::v23 and ID3v24::v24 if they are not null and clear their pointers.
 		 */
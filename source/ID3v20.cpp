@@ -56,7 +56,7 @@ void ID3v20FrameHeader::setFrameSize(uint32_t size){
 }
 
 ID3v20Frame::ID3v20Frame() :
-	data(nullptr){
+	data(nullptr), sourceOffset(0){
 	header = {};
 }
 
@@ -64,11 +64,23 @@ ID3v20Frame::~ID3v20Frame(){
 	header = {};
 
 	if(data != nullptr){
-		delete data;
+		delete[] data;
 		data = nullptr;
 	}
 }
 
+uint8_t* ID3v20Frame::getData(){
+	if(data == nullptr && source != nullptr){
+		uint32_t size = header.getFrameSize();
+		if(sourceOffset + size <= source->size()){
+			data = new uint8_t[size];
+			std::memcpy(data, &(*source)[sourceOffset], size);
+		}
+		source.reset();
+	}
+	return data;
+}
+
 ID3v20::ID3v20(){
 	header = {};
 }
@@ -107,6 +119,13 @@ void ID3v20::setFrame(uint8_t identifier[3], uint32_t size, uint8_t* data){
 	frames.push_back(frame);
 }
 
+void ID3v20::addFrame(ID3v20Frame* frame){
+	if(frame == nullptr){
+		return;
+	}
+	frames.push_back(frame);
+}
+
 void ID3v20::removeFrame(ID3v20Frame* frame){
 	for(auto it = frames.begin(); it != frames.end(); ++it){
 		if(*it == frame){
@@ -117,11 +136,47 @@ void ID3v20::removeFrame(ID3v20Frame* frame){
 	}
 }
 
+uint32_t ID3v20::getFramesSize() const{
+	uint32_t framesSize = 0;
+	for(auto frame : frames){
+		framesSize += sizeof(frame->header.identifier) + sizeof(frame->header.size) + frame->header.getFrameSize();
+	}
+	return framesSize;
+}
+
+std::vector<uint8_t> ID3v20::toBytes(uint32_t padding) const{
+	ID3v20Header tagHeader;
+	tagHeader.revision_number = header.revision_number;
+	tagHeader.setTagSize(getFramesSize() + padding);
+
+	std::vector<uint8_t> bytes;
+	bytes.reserve(10 + tagHeader.getTagSize());
+	bytes.insert(bytes.end(), tagHeader.tag, tagHeader.tag + 3);
+	bytes.push_back(tagHeader.major_version);
+	bytes.push_back(tagHeader.revision_number);
+	bytes.push_back(tagHeader.flags);
+	bytes.insert(bytes.end(), tagHeader.size, tagHeader.size + 4);
+
+	for(auto frame : frames){
+		bytes.insert(bytes.end(), frame->header.identifier, frame->header.identifier + 3);
+		bytes.insert(bytes.end(), frame->header.size, frame->header.size + 3);
+		uint8_t* payload = frame->getData();
+		if(payload != nullptr){
+			bytes.insert(bytes.end(), payload, payload + frame->header.getFrameSize());
+		}
+	}
+
+	bytes.resize(bytes.size() + padding, 0);
+
+	return bytes;
+}
+
 std::string ID3v20::getTitle() const{
 	uint8_t identifier[3] = {'T', 'T', '2'};
 	ID3v20Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -135,7 +190,8 @@ std::string ID3v20::getArtist() const{
 	uint8_t identifier[3] = {'T', 'P', '1'};
 	ID3v20Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -149,7 +205,8 @@ std::string ID3v20::getAlbum() const{
 	uint8_t identifier[3] = {'T', 'A', 'L'};
 	ID3v20Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -163,7 +220,8 @@ std::string ID3v20::getYear() const{
 	uint8_t identifier[3] = {'T', 'Y', 'E'};
 	ID3v20Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -178,7 +236,8 @@ std::string ID3v20::getComment() const{
 	ID3v20Frame* frame = getFrame(identifier);
 
 	if(frame != nullptr){
-		std::string frameData(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		std::string frameData(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 
 		std::string language = "eng";
 
@@ -216,7 +275,8 @@ uint8_t ID3v20::getTrack() const{
 	ID3v20Frame* frame = getFrame(identifier);
 
 	if(frame != nullptr){
-		std::string trackString(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		std::string trackString(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 		size_t slashPosition = trackString.find('/');
 		if(slashPosition != std::string::npos){
 			trackString = trackString.substr(0, slashPosition);
@@ -240,7 +300,8 @@ ID3v10::Genre ID3v20::getGenre() const{
 	ID3v20Frame* frame = getFrame(identifier);
 
 	if(frame != nullptr){
-		std::string genreString(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		std::string genreString(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 		if(genreString.front() == '(' && genreString.back() == ')'){
 			genreString = genreString.substr(1, genreString.size() - 2);
 		}
@@ -12,6 +12,7 @@
 #include "ID3v10.hpp"
 #include "ID3v2.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -112,6 +113,13 @@ struct ID3v20Frame{
 	 */
 	virtual ~ID3v20Frame();
 
+	/**
+	 * @brief Get the data, copying it from ID3v20Frame::source on first use.
+	 *
+	 * @return Pointer to the data, header.getFrameSize() bytes long, nullptr if the frame has no data.
+	 */
+	uint8_t* getData();
+
 	/**
 	 * @var ID3v20FrameHeader ID3v20Frame::header
 	 *
@@ -125,8 +133,23 @@ struct ID3v20Frame{
 	 * @brief Pointer to the data of the ID3v2.0 frame.
 	 *
 	 * @note This pointer may point to dynamically allocated memory for frame data.
+	 * @note It is nullptr until getData() is called when the frame was read lazily, see MP3File::setLazyFrames().
 	 */
 	uint8_t* data;
+
+	/**
+	 * @var std::shared_ptr<const std::vector<uint8_t>> ID3v20Frame::source
+	 *
+	 * @brief Bytes of the tag the data is copied from by getData(), shared by all frames of a lazily read tag.
+	 */
+	std::shared_ptr<const std::vector<uint8_t>> source;
+
+	/**
+	 * @var uint64_t ID3v20Frame::sourceOffset
+	 *
+	 * @brief Offset of the data in ID3v20Frame::source.
+	 */
+	uint64_t sourceOffset;
 };
 
 /**
@@ -167,6 +190,13 @@ class ID3v20{
 		 */
 		void setFrame(uint8_t identifier[3], uint32_t size, uint8_t* data);
 
+		/**
+		 * @brief Adds the given frame to the tag, taking ownership of it.
+		 *
+		 * @param frame Pointer to a frame allocated with new, like the ones from ID3v2FrameView::toID3v20Frame(). Ignored if nullptr.
+		 */
+		void addFrame(ID3v20Frame* frame);
+
 		/**
 		 * @brief Removes a specified frame from the tag.
 		 *
@@ -174,6 +204,22 @@ class ID3v20{
 		 */
 		void removeFrame(ID3v20Frame* frame);
 
+		/**
+		 * @brief Get the size of all frames, including their 6 byte headers.
+		 *
+		 * @return The size in bytes the frames occupy in the tag.
+		 */
+		uint32_t getFramesSize() const;
+
+		/**
+		 * @brief Serializes the tag: header, frames and zero padding.
+		 *
+		 * @param padding Number of zero bytes written after the last frame.
+		 *
+		 * @return The bytes of the whole tag, 10 + getFramesSize() + padding long.
+		 */
+		std::vector<uint8_t> toBytes(uint32_t padding) const;
+
 		/**
 		 * @brief Retrieves the title from the tag.
 		 *
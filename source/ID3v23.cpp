@@ -190,7 +190,7 @@ bool ID3v23FrameHeader::isGroupingIdentity() const{
 }
 
 ID3v23Frame::ID3v23Frame() :
-	data(nullptr){
+	data(nullptr), sourceOffset(0), sourceVersion(3){
 	header = {};
 }
 
@@ -203,8 +203,82 @@ ID3v23Frame::~ID3v23Frame(){
 	}
 }
 
+uint8_t* ID3v23Frame::getData(){
+	if(data == nullptr && source != nullptr){
+		if(sourceOffset + header.getFrameSize() <= source->size()){
+			decode(&(*source)[sourceOffset], sourceVersion);
+		}
+		source.reset();
+	}
+	return data;
+}
+
+void ID3v23Frame::setData(const uint8_t* data, uint32_t size){
+	if(this->data != nullptr){
+		delete[] this->data;
+		this->data = nullptr;
+	}
+
+	// Flags of a version 2.4 payload that was never decoded no longer apply to the new data
+	if(source != nullptr && sourceVersion == 4){
+		header.flags[1] &= ~0x03;
+	}
+	source.reset();
+
+	this->data = new uint8_t[size];
+	std::memcpy(this->data, data, size);
+	header.setFrameSize(size);
+}
+
+void ID3v23Frame::decode(const uint8_t* payload, uint8_t version){
+	uint32_t size = header.getFrameSize();
+
+	if(data != nullptr){
+		delete[] data;
+		data = nullptr;
+	}
+
+	// A compressed or encrypted version 2.4 payload is kept as it is, with its data length indicator and flags,
+	// which compression requires: decoding it would need the compression or the encryption method
+	bool isPacked = version == 4 && (header.flags[1] & 0x0C) != 0;
+	bool hasDataLengthIndicator = version == 4 && isPacked == false && (header.flags[1] & 0x01) != 0;
+	bool isUnsynchronized = version == 4 && isPacked == false && (header.flags[1] & 0x02) != 0;
+
+	// The group identifier comes before the data length indicator, it stays first in the data with its flag
+	uint32_t groupSize = version == 4 && isPacked == false && (header.flags[1] & 0x40) != 0 && size > 0 ? 1 : 0;
+	uint8_t group = groupSize > 0 ? payload[0] : 0;
+	payload += groupSize;
+	size -= groupSize;
+
+	if(hasDataLengthIndicator == true && size >= 4){
+		payload += 4;
+		size -= 4;
+		header.flags[1] &= ~0x01;
+	}
+
+	data = new uint8_t[groupSize + size];
+	if(groupSize > 0){
+		data[0] = group;
+	}
+	if(isUnsynchronized == true){
+		uint32_t decodedSize = 0;
+		for(uint32_t i = 0; i < size; i++){
+			data[groupSize + decodedSize++] = payload[i];
+			if(payload[i] == 0xFF && i + 1 < size && payload[i + 1] == 0x00){
+				i++;
+			}
+		}
+		size = decodedSize;
+		header.flags[1] &= ~0x02;
+	}else{
+		std::memcpy(&data[groupSize], payload, size);
+	}
+
+	header.setFrameSize(groupSize + size);
+}
+
 ID3v23::ID3v23() :
-	extendedHeader(nullptr){
+	extendedHeader(nullptr), indexedFrames(0){
 	header = {};
 }
 
@@ -214,6 +288,8 @@ ID3v23::~ID3v23(){
 		frame = nullptr;
 	}
 	frames.clear();
+	frameIndex.clear();
+	indexedFrames = 0;
 
 	if(extendedHeader != nullptr){
 		delete extendedHeader;
@@ -263,27 +339,34 @@ void ID3v23::print(){
 }
 
 ID3v23Frame* ID3v23::getFrame(uint8_t identifier[4]) const {
-	for(auto frame : frames){
-		if(std::memcmp(frame->header.identifier, identifier, 4) == 0){
-			return frame;
-		}
+	updateFrameIndex();
+
+	auto it = frameIndex.find(toFrameKey(identifier));
+	if(it != frameIndex.end() && it->second.empty() == false){
+		return it->second.front();
 	}
 	return nullptr;
 }
 
+std::vector<ID3v23Frame*> ID3v23::getFrames(uint8_t identifier[4]) const{
+	updateFrameIndex();
+
+	auto it = frameIndex.find(toFrameKey(identifier));
+	if(it != frameIndex.end()){
+		return it->second;
+	}
+	return std::vector<ID3v23Frame*>();
+}
+
 bool ID3v23::setFrame(uint8_t identifier[4], uint32_t size, uint8_t* data){
 	if(size == 0 || data == nullptr){
 		return false;
 	}
 
-	for(auto& frame : frames){
-		if(std::memcmp(frame->header.identifier, identifier, 4) == 0){
-			delete[] frame->data;
-			frame->data = new uint8_t[size];
-			std::memcpy(frame->data, data, size);
-			frame->header.setFrameSize(size);
-			return true;
-		}
+	ID3v23Frame* frame = getFrame(identifier);
+	if(frame != nullptr){
+		frame->setData(data, size);
+		return true;
 	}
 	return false;
 }
@@ -297,24 +380,142 @@ void ID3v23::addFrame(uint8_t identifier[4], uint32_t size, uint8_t* data){
 	frame->header.setFrameSize(size);
 	frame->data = new uint8_t[size];
 	std::memcpy(frame->data, data, size);
+	addFrame(frame);
+}
+
+void ID3v23::addFrame(ID3v23Frame* frame){
+	if(frame == nullptr){
+		return;
+	}
+	updateFrameIndex();
+
 	frames.push_back(frame);
+	frameIndex[toFrameKey(frame->header.identifier)].push_back(frame);
+	indexedFrames++;
 }
 
 void ID3v23::removeFrame(ID3v23Frame* frame){
 	for(auto it = frames.begin(); it != frames.end(); ++it){
 		if(*it == frame){
+			updateFrameIndex();
+
+			bool unindexed = false;
+			auto indexed = frameIndex.find(toFrameKey(frame->header.identifier));
+			if(indexed != frameIndex.end()){
+				std::vector<ID3v23Frame*>& sameFrames = indexed->second;
+				for(auto same = sameFrames.begin(); same != sameFrames.end(); ++same){
+					if(*same == frame){
+						sameFrames.erase(same);
+						unindexed = true;
+						break;
+					}
+				}
+				if(sameFrames.empty() == true){
+					frameIndex.erase(indexed);
+				}
+			}
+
 			delete frame;
 			frames.erase(it);
+
+			// The identifier was changed after the frame was indexed, index all frames again
+			if(unindexed == false){
+				indexedFrames = frames.size() + 1;
+			}else{
+				indexedFrames--;
+			}
+			updateFrameIndex();
 			break;
 		}
 	}
 }
 
+uint32_t ID3v23::toFrameKey(const uint8_t identifier[4]){
+	uint32_t key = 0;
+	key |= static_cast<uint32_t>(identifier[0]) << 24;
+	key |= static_cast<uint32_t>(identifier[1]) << 16;
+	key |= static_cast<uint32_t>(identifier[2]) << 8;
+	key |= identifier[3];
+	return key;
+}
+
+void ID3v23::updateFrameIndex() const{
+	if(indexedFrames == frames.size()){
+		return;
+	}
+
+	frameIndex.clear();
+	for(auto frame : frames){
+		frameIndex[toFrameKey(frame->header.identifier)].push_back(frame);
+	}
+	indexedFrames = frames.size();
+}
+
+uint32_t ID3v23::getFramesSize() const{
+	uint32_t framesSize = 0;
+	for(auto frame : frames){
+		framesSize += sizeof(ID3v23FrameHeader::identifier) + sizeof(ID3v23FrameHeader::size) + sizeof(ID3v23FrameHeader::flags) + frame->header.getFrameSize();
+	}
+	return framesSize;
+}
+
+std::vector<uint8_t> ID3v23::toBytes(uint32_t padding) const{
+	uint32_t tagSize = getFramesSize() + padding;
+
+	std::vector<uint8_t> bytes(10);
+	bytes.reserve(10 + tagSize);
+	writeHeader(bytes.data(), tagSize, false);
+
+	for(auto frame : frames){
+		uint32_t frameSize = frame->header.getFrameSize();
+		uint8_t frameHeader[10];
+		std::memcpy(frameHeader, frame->header.identifier, 4);
+		writeFrameSize(&frameHeader[4], frameSize);
+		std::memcpy(&frameHeader[8], frame->header.flags, 2);
+
+		bytes.insert(bytes.end(), frameHeader, frameHeader + 10);
+		// A frame read lazily and never decoded is written back as stored, with its stored flags and size
+		const uint8_t* payload = frame->data;
+		if(payload == nullptr && frame->source != nullptr && frame->sourceOffset + frameSize <= frame->source->size()){
+			payload = &(*frame->source)[frame->sourceOffset];
+		}
+		if(payload != nullptr){
+			bytes.insert(bytes.end(), payload, payload + frameSize);
+		}
+	}
+
+	bytes.resize(bytes.size() + padding, 0);
+
+	return bytes;
+}
+
+void ID3v23::writeHeader(uint8_t out[10], uint32_t tagSize, bool hasFooter) const{
+	ID3v23Header tagHeader;
+	tagHeader.revision_number = header.revision_number;
+	tagHeader.setExperimental(header.isExperimental());
+	tagHeader.setTagSize(tagSize);
+	(void)hasFooter;
+
+	std::memcpy(out, tagHeader.tag, 3);
+	out[3] = tagHeader.major_version;
+	out[4] = tagHeader.revision_number;
+	out[5] = tagHeader.flags;
+	std::memcpy(&out[6], tagHeader.size, 4);
+}
+
+void ID3v23::writeFrameSize(uint8_t out[4], uint32_t frameSize) const{
+	out[0] = (frameSize >> 24) & 0xFF;
+	out[1] = (frameSize >> 16) & 0xFF;
+	out[2] = (frameSize >> 8) & 0xFF;
+	out[3] = frameSize & 0xFF;
+}
+
 std::string ID3v23::getTitle() const{
 	uint8_t identifier[4] = {'T', 'I', 'T', '2'};
 	ID3v23Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -328,7 +529,8 @@ std::string ID3v23::getArtist() const{
 	uint8_t identifier[4] = {'T', 'P', 'E', '1'};
 	ID3v23Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -342,7 +544,8 @@ std::string ID3v23::getAlbum() const{
 	uint8_t identifier[4] = {'T', 'A', 'L', 'B'};
 	ID3v23Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -356,7 +559,8 @@ std::string ID3v23::getYear() const{
 	uint8_t identifier[4] = {'T', 'Y', 'E', 'R'};
 	ID3v23Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -372,7 +576,8 @@ std::string ID3v23::getComment() const{
 	uint8_t identifier[4] = {'C', 'O', 'M', 'M'};
 	ID3v23Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -400,7 +605,8 @@ std::string ID3v23::getTrack() const{
 	uint8_t identifier[4] = {'T', 'R', 'C', 'K'};
 	ID3v23Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
@@ -417,7 +623,8 @@ std::string ID3v23::getGenre() const{
 	uint8_t identifier[4] = {'T', 'C', 'O', 'N'};
 	ID3v23Frame* frame = getFrame(identifier);
 	if(frame != nullptr){
-		return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+		uint8_t* payload = frame->getData();
+		return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
 	}
 	return "";
 }
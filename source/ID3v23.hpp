@@ -12,7 +12,9 @@
 #include "ID3v10.hpp"
 #include "ID3v2.hpp"
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -272,6 +274,34 @@ struct ID3v23Frame {
      */
     virtual ~ID3v23Frame();
 
+    /**
+     * @brief Get the decoded data, decoding it from ID3v23Frame::source on first use.
+     *
+     * @return Pointer to the data, header.getFrameSize() bytes long, nullptr if the frame has no data.
+     *
+     * @note Read header.getFrameSize() after calling it, decoding a version 2.4 frame may change its size.
+     */
+    uint8_t* getData();
+
+    /**
+     * @brief Replace the data with a copy of the given bytes, dropping the source.
+     *
+     * @param data Pointer to the data to be copied into the frame.
+     * @param size The size of the data in bytes.
+     */
+    void setData(const uint8_t* data, uint32_t size);
+
+    /**
+     * @brief Copy the payload as stored in a tag of the given version into ID3v23Frame::data.
+     *
+     * For version 2.4 the frame unsynchronization is undone and the data length indicator removed, clearing
+     * their flags. Compressed and encrypted payloads are kept as stored. The header size must be set before.
+     *
+     * @param payload Pointer to the stored payload, header.getFrameSize() bytes long.
+     * @param version Major version of the tag, 3 or 4.
+     */
+    void decode(const uint8_t* payload, uint8_t version);
+
     /**
      * @var ID3v23FrameHeader ID3v23Frame::header
      *
@@ -285,8 +315,30 @@ struct ID3v23Frame {
      * @brief Pointer to the data of the ID3v2.3 frame.
      *
      * @note This pointer may point to dynamically allocated memory for frame data.
+     * @note It is nullptr until getData() is called when the frame was read lazily, see MP3File::setLazyFrames().
      */
     uint8_t* data;
+
+    /**
+     * @var std::shared_ptr<const std::vector<uint8_t>> ID3v23Frame::source
+     *
+     * @brief Bytes of the tag the payload is decoded from by getData(), shared by all frames of a lazily read tag.
+     */
+    std::shared_ptr<const std::vector<uint8_t>> source;
+
+    /**
+     * @var uint64_t ID3v23Frame::sourceOffset
+     *
+     * @brief Offset of the stored payload in ID3v23Frame::source.
+     */
+    uint64_t sourceOffset;
+
+    /**
+     * @var uint8_t ID3v23Frame::sourceVersion
+     *
+     * @brief Major version of the tag in ID3v23Frame::source, 3 or 4.
+     */
+    uint8_t sourceVersion;
 };
 
 /**
@@ -309,7 +361,7 @@ class ID3v23{
 		void print();
 
 		/**
-		 * @brief Search through the vector of frames to find a frame with the given identifier.
+		 * @brief Find the first frame with the given identifier in the frame index.
 		 *
 		 * @param identifier A 4 byte array representing the identifier of the frame.
 		 *
@@ -317,6 +369,15 @@ class ID3v23{
 		 */
 		ID3v23Frame* getFrame(uint8_t identifier[4]) const;
 
+		/**
+		 * @brief Get all frames with the given identifier, for frames that may repeat like TXXX, PRIV or CHAP.
+		 *
+		 * @param identifier A 4 byte array representing the identifier of the frame.
+		 *
+		 * @return The frames in tag order, empty if none.
+		 */
+		std::vector<ID3v23Frame*> getFrames(uint8_t identifier[4]) const;
+
 		/**
 		 * @brief Updates the first occurrence of a frame with the given identifier, if present.
 		 *
@@ -340,6 +401,13 @@ class ID3v23{
 		 */
 		void addFrame(uint8_t identifier[4], uint32_t size, uint8_t* data);
 
+		/**
+		 * @brief Adds the given frame to the tag, taking ownership of it.
+		 *
+		 * @param frame Pointer to a frame allocated with new, like the ones from ID3v2FrameView::toID3v23Frame(). Ignored if nullptr.
+		 */
+		void addFrame(ID3v23Frame* frame);
+
 		/**
 		 * @brief Removes a specified frame from the tag.
 		 *
@@ -347,6 +415,24 @@ class ID3v23{
 		 */
 		void removeFrame(ID3v23Frame* frame);
 
+		/**
+		 * @brief Get the size of all frames, including their 10 byte headers.
+		 *
+		 * @return The size in bytes the frames occupy in the tag.
+		 */
+		uint32_t getFramesSize() const;
+
+		/**
+		 * @brief Serializes the tag: header, frames and zero padding.
+		 *
+		 * @param padding Number of zero bytes written after the last frame.
+		 *
+		 * @return The bytes of the whole tag, 10 + getFramesSize() + padding long.
+		 *
+		 * @note The extended header and unsynchronization are not written.
+		 */
+		virtual std::vector<uint8_t> toBytes(uint32_t padding) const;
+
 		/**
 		 * @brief Retrieves the title from the tag.
 		 *
@@ -445,6 +531,24 @@ class ID3v23{
 		 */
 		void setGenre(ID3v10::Genre genre);
 
+	protected:
+		/**
+		 * @brief Writes the 10 byte tag header.
+		 *
+		 * @param out Buffer to write the header to.
+		 * @param tagSize Size of the tag excluding the header.
+		 * @param hasFooter Whether a footer follows the tag.
+		 */
+		virtual void writeHeader(uint8_t out[10], uint32_t tagSize, bool hasFooter) const;
+
+		/**
+		 * @brief Writes the 4 byte size of a frame header, big-endian in version 2.3.
+		 *
+		 * @param out Buffer to write the size to.
+		 * @param frameSize Size of the frame excluding its header.
+		 */
+		virtual void writeFrameSize(uint8_t out[4], uint32_t frameSize) const;
+
 	public:
 		/**
 		 * @var ID3v23Header ID3v23::header
@@ -468,8 +572,25 @@ class ID3v23{
 		 * @brief Vector containing pointers to ID3v2.3 frames.
 		 *
 		 * @note Frames are dynamically allocated and managed.
+		 * @note Change it through addFrame(), setFrame() and removeFrame() so the frame index is kept, the index is only
+		 *       rebuilt by itself when the number of frames changes.
 		 */
 		std::vector<ID3v23Frame*> frames;
+
+	private:
+		/**
+		 * @brief Pack a 4 byte frame identifier into the key of the frame index.
+		 */
+		static uint32_t toFrameKey(const uint8_t identifier[4]);
+
+		/**
+		 * @brief Rebuild the frame index if frames was changed without addFrame() or removeFrame().
+		 */
+		void updateFrameIndex() const;
+
+	private:
+		mutable std::unordered_map<uint32_t, std::vector<ID3v23Frame*>> frameIndex;	///< Frames by packed identifier, in tag order.
+		mutable std::size_t indexedFrames;	///< Number of frames in frameIndex.
 };
 
 #endif /* ID3V23_HPP */
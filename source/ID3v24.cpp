@@ -69,6 +69,8 @@ bool ID3v24Header::hasFooter() const {
 }
 
 ID3v24::ID3v24() {
+    // Keep the inherited header in agreement, ID3v2::getVersion() reads it through the ID3v23 base.
+    ID3v23::header.major_version = 4;
 }
 
 ID3v24::~ID3v24() {
@@ -82,11 +84,49 @@ void ID3v24::readFooter(const uint8_t* in) {
     footer.fromBytes(in);
 }
 
+std::vector<uint8_t> ID3v24::toBytes(uint32_t padding) const {
+    std::vector<uint8_t> bytes = ID3v23::toBytes(padding);
+
+    if (padding == 0 && header.hasFooter()) {
+        uint32_t tagSize = static_cast<uint32_t>(bytes.size()) - 10;
+        writeHeader(bytes.data(), tagSize, true);
+
+        ID3v24Footer tagFooter;
+        tagFooter.setFooter(bytes[5], &bytes[6]);
+        bytes.resize(bytes.size() + 10);
+        tagFooter.toBytes(&bytes[bytes.size() - 10]);
+    }
+
+    return bytes;
+}
+
+void ID3v24::writeHeader(uint8_t out[10], uint32_t tagSize, bool hasFooter) const {
+    ID3v24Header tagHeader;
+    tagHeader.revision_number = header.revision_number;
+    tagHeader.setExperimental(header.isExperimental());
+    tagHeader.setFooterPresent(hasFooter);
+    tagHeader.setTagSize(tagSize);
+
+    std::memcpy(out, tagHeader.tag, 3);
+    out[3] = tagHeader.major_version;
+    out[4] = tagHeader.revision_number;
+    out[5] = tagHeader.flags;
+    std::memcpy(&out[6], tagHeader.size, 4);
+}
+
+void ID3v24::writeFrameSize(uint8_t out[4], uint32_t frameSize) const {
+    out[0] = static_cast<uint8_t>((frameSize >> 21) & 0x7F);
+    out[1] = static_cast<uint8_t>((frameSize >> 14) & 0x7F);
+    out[2] = static_cast<uint8_t>((frameSize >> 7) & 0x7F);
+    out[3] = static_cast<uint8_t>(frameSize & 0x7F);
+}
+
 std::string ID3v24::getYear() const {
     uint8_t identifier[4] = {'T', 'D', 'R', 'C'};
     ID3v23Frame* frame = getFrame(identifier);
     if(frame != nullptr){
-        return std::string(reinterpret_cast<char*>(frame->data), frame->header.getFrameSize());
+        uint8_t* payload = frame->getData();
+        return std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
     }
     return "";
 }
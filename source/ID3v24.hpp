@@ -182,6 +182,37 @@ public:
 	 */
 	void readFooter(const uint8_t* in);
 
+	/**
+	 * @brief Serializes the tag: header, frames, zero padding and the footer if ID3v24Header::hasFooter().
+	 *
+	 * @param padding Number of zero bytes written after the last frame.
+	 *
+	 * @return The bytes of the whole tag.
+	 *
+	 * @note A tag with padding can not have a footer, so the footer is only written when padding is 0.
+	 */
+	std::vector<uint8_t> toBytes(uint32_t padding) const override;
+
+protected:
+	/**
+	 * @brief Writes the 10 byte tag header with the version 2.4 flags.
+	 *
+	 * @param out Buffer to write the header to.
+	 * @param tagSize Size of the tag excluding header and footer.
+	 * @param hasFooter Whether a footer follows the tag.
+	 */
+	void writeHeader(uint8_t out[10], uint32_t tagSize, bool hasFooter) const override;
+
+	/**
+	 * @brief Writes the 4 byte size of a frame header, synchsafe in version 2.4.
+	 *
+	 * @param out Buffer to write the size to.
+	 * @param frameSize Size of the frame excluding its header.
+	 */
+	void writeFrameSize(uint8_t out[4], uint32_t frameSize) const override;
+
+public:
+
 	/**
 	 * @var header
 	 *
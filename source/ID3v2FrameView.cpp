@@ -0,0 +1,203 @@
+#include "ID3v2FrameView.hpp"
+
+#include <cstring>
+
+static uint32_t readSynchsafe(const uint8_t* in){
+	uint32_t value = 0;
+	value |= static_cast<uint32_t>(in[0] & 0x7F) << 21;
+	value |= static_cast<uint32_t>(in[1] & 0x7F) << 14;
+	value |= static_cast<uint32_t>(in[2] & 0x7F) << 7;
+	value |= static_cast<uint32_t>(in[3] & 0x7F);
+	return value;
+}
+
+static uint32_t readBigEndian(const uint8_t* in, uint8_t count){
+	uint32_t value = 0;
+	for(uint8_t i = 0; i < count; i++){
+		value = (value << 8) | in[i];
+	}
+	return value;
+}
+
+static bool isIdentifierCharacter(uint8_t character){
+	return (character >= 'A' && character <= 'Z') || (character >= '0' && character <= '9');
+}
+
+ID3v2FrameView::ID3v2FrameView() :
+	version(0), identifier{0, 0, 0, 0}, flags{0, 0}, data(nullptr), size(0), offset(0){
+
+}
+
+ID3v2FrameView::~ID3v2FrameView(){
+
+}
+
+bool ID3v2FrameView::isIdentifier(const char* identifier) const{
+	uint8_t identifierSize = version == 2 ? 3 : 4;
+	return std::strlen(identifier) == identifierSize && std::memcmp(this->identifier, identifier, identifierSize) == 0;
+}
+
+std::string ID3v2FrameView::getIdentifier() const{
+	return std::string(reinterpret_cast<const char*>(identifier), version == 2 ? 3 : 4);
+}
+
+ID3v20Frame* ID3v2FrameView::toID3v20Frame() const{
+	if(version != 2){
+		return nullptr;
+	}
+
+	ID3v20Frame* frame = new ID3v20Frame();
+	std::memcpy(frame->header.identifier, identifier, 3);
+	frame->header.setFrameSize(size);
+	frame->data = new uint8_t[size];
+	std::memcpy(frame->data, data, size);
+
+	return frame;
+}
+
+ID3v20Frame* ID3v2FrameView::toID3v20Frame(const std::shared_ptr<const std::vector<uint8_t>>& tag) const{
+	if(version != 2){
+		return nullptr;
+	}
+
+	ID3v20Frame* frame = new ID3v20Frame();
+	std::memcpy(frame->header.identifier, identifier, 3);
+	frame->header.setFrameSize(size);
+	frame->source = tag;
+	frame->sourceOffset = offset + 6;
+
+	return frame;
+}
+
+ID3v23Frame* ID3v2FrameView::toID3v23Frame() const{
+	if(version != 3 && version != 4){
+		return nullptr;
+	}
+
+	ID3v23Frame* frame = new ID3v23Frame();
+	std::memcpy(frame->header.identifier, identifier, 4);
+	std::memcpy(frame->header.flags, flags, 2);
+	frame->header.setFrameSize(size);
+	frame->decode(data, version);
+
+	return frame;
+}
+
+ID3v23Frame* ID3v2FrameView::toID3v23Frame(const std::shared_ptr<const std::vector<uint8_t>>& tag) const{
+	if(version != 3 && version != 4){
+		return nullptr;
+	}
+
+	ID3v23Frame* frame = new ID3v23Frame();
+	std::memcpy(frame->header.identifier, identifier, 4);
+	std::memcpy(frame->header.flags, flags, 2);
+	frame->header.setFrameSize(size);
+	frame->source = tag;
+	frame->sourceOffset = offset + 10;
+	frame->sourceVersion = version;
+
+	return frame;
+}
+
+ID3v2FrameReader::ID3v2FrameReader(const uint8_t* tag, uint64_t size, uint64_t limit) :
+	tag(tag), end(0), tagEnd(0), position(0), version(0), truncated(false){
+	if(tag == nullptr || size < 10 || tag[0] != 'I' || tag[1] != 'D' || tag[2] != '3'){
+		return;
+	}
+
+	if(tag[3] != 2 && tag[3] != 3 && tag[3] != 4){
+		return;
+	}
+
+	version = tag[3];
+	tagEnd = 10 + static_cast<uint64_t>(readSynchsafe(&tag[6]));
+	if(limit > 0 && tagEnd > limit){
+		tagEnd = limit;
+	}
+	end = tagEnd;
+	if(end > size){
+		end = size;
+	}
+	position = 10;
+
+	// Extended header: the size excludes itself in version 2.3 and includes itself in version 2.4
+	bool hasExtendedHeader = version != 2 && (tag[5] & 0x40) != 0;
+	if(hasExtendedHeader == true && position + 4 <= end){
+		if(version == 3){
+			position += 4 + readBigEndian(&tag[position], 4);
+		}else{
+			position += readSynchsafe(&tag[position]);
+		}
+	}
+}
+
+ID3v2FrameReader::~ID3v2FrameReader(){
+
+}
+
+bool ID3v2FrameReader::isValid() const{
+	return version != 0;
+}
+
+uint8_t ID3v2FrameReader::getVersion() const{
+	return version;
+}
+
+bool ID3v2FrameReader::next(ID3v2FrameView& view){
+	if(version == 0){
+		return false;
+	}
+
+	truncated = false;
+
+	uint64_t headerSize = version == 2 ? 6 : 10;
+	if(position + headerSize > end){
+		truncated = end < tagEnd;
+		return false;
+	}
+	if(isIdentifierCharacter(tag[position]) == false){
+		return false;
+	}
+
+	const uint8_t* header = &tag[position];
+	uint32_t frameSize = 0;
+	if(version == 2){
+		frameSize = readBigEndian(&header[3], 3);
+	}else if(version == 3){
+		frameSize = readBigEndian(&header[4], 4);
+	}else{
+		frameSize = readSynchsafe(&header[4]);
+	}
+
+	if(position + headerSize + frameSize > end){
+		truncated = end < tagEnd && position + headerSize + frameSize <= tagEnd;
+		return false;
+	}
+
+	view = ID3v2FrameView();
+	view.version = version;
+	std::memcpy(view.identifier, header, version == 2 ? 3 : 4);
+	if(version != 2){
+		std::memcpy(view.flags, &header[8], 2);
+	}
+	view.data = &header[headerSize];
+	view.size = frameSize;
+	view.offset = position;
+
+	position += headerSize + frameSize;
+
+	return true;
+}
+
+std::vector<ID3v2FrameView> ID3v2FrameReader::readAll(){
+	std::vector<ID3v2FrameView> views;
+	ID3v2FrameView view;
+	while(next(view) == true){
+		views.push_back(view);
+	}
+	return views;
+}
+
+bool ID3v2FrameReader::isTruncated() const{
+	return truncated;
+}
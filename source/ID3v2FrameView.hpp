@@ -0,0 +1,209 @@
+#ifndef ID3V2FRAMEVIEW_HPP
+#define ID3V2FRAMEVIEW_HPP
+
+/**
+ * @file ID3v2FrameView.hpp
+ *
+ * @author Evandro L. Vieira
+ *
+ * @brief This file contains the definition of the class ID3v2FrameView and class ID3v2FrameReader.
+ */
+
+#include "ID3v20.hpp"
+#include "ID3v23.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class ID3v2FrameView
+ *
+ * @brief Read-only view of an ID3v2.0, ID3v2.3 or ID3v2.4 frame that points into the tag bytes instead of copying them.
+ *
+ * @note A view is only valid while the buffer it was read from is unchanged, see MP3File::getFrameViews().
+ *       Use toID3v20Frame() or toID3v23Frame() to get an owned frame that can be changed.
+ */
+class ID3v2FrameView{
+	public:
+		/**
+		 * @brief Default constructor that initializes an empty view.
+		 */
+		ID3v2FrameView();
+
+		/**
+		 * @brief Default virtual destructor.
+		 */
+		virtual ~ID3v2FrameView();
+
+		/**
+		 * @brief Check if the frame has the given identifier.
+		 *
+		 * @param identifier 3 characters for version 2.0, 4 characters for versions 2.3 and 2.4.
+		 *
+		 * @return true if the identifier matches, false otherwise.
+		 */
+		bool isIdentifier(const char* identifier) const;
+
+		/**
+		 * @brief Get the identifier as string.
+		 *
+		 * @return The 3 or 4 character identifier.
+		 */
+		std::string getIdentifier() const;
+
+		/**
+		 * @brief Copy the frame into a new owned ID3v2.0 frame.
+		 *
+		 * @return A new ID3v20Frame the caller owns, or nullptr if this is not a version 2.0 frame.
+		 */
+		ID3v20Frame* toID3v20Frame() const;
+
+		/**
+		 * @brief Create an ID3v2.0 frame that copies its data from the given tag bytes on first use.
+		 *
+		 * @param tag Copy of the bytes of the tag the view was read from, starting with "ID3".
+		 *
+		 * @return A new ID3v20Frame the caller owns, or nullptr if this is not a version 2.0 frame.
+		 */
+		ID3v20Frame* toID3v20Frame(const std::shared_ptr<const std::vector<uint8_t>>& tag) const;
+
+		/**
+		 * @brief Copy the frame into a new owned ID3v2.3 frame, also used by ID3v24.
+		 *
+		 * @return A new ID3v23Frame the caller owns, or nullptr if this is a version 2.0 frame.
+		 *
+		 * @note The frame size is stored as a plain integer for both versions 2.3 and 2.4.
+		 * @note The payload is decoded by ID3v23Frame::decode(), so the frame size may differ from ID3v2FrameView::size.
+		 */
+		ID3v23Frame* toID3v23Frame() const;
+
+		/**
+		 * @brief Create an ID3v2.3 frame, also used by ID3v24, that decodes its payload from the given tag bytes on first use.
+		 *
+		 * @param tag Copy of the bytes of the tag the view was read from, starting with "ID3".
+		 *
+		 * @return A new ID3v23Frame the caller owns, or nullptr if this is a version 2.0 frame.
+		 */
+		ID3v23Frame* toID3v23Frame(const std::shared_ptr<const std::vector<uint8_t>>& tag) const;
+
+	public:
+		/**
+		 * @var uint8_t ID3v2FrameView::version
+		 *
+		 * @brief Major version of the tag the frame belongs to: 2, 3 or 4.
+		 */
+		uint8_t version;
+
+		/**
+		 * @var uint8_t ID3v2FrameView::identifier[4]
+		 *
+		 * @brief Frame identifier, the last byte is 0 for version 2.0.
+		 */
+		uint8_t identifier[4];
+
+		/**
+		 * @var uint8_t ID3v2FrameView::flags[2]
+		 *
+		 * @brief Frame flags as stored, always 0 for version 2.0.
+		 */
+		uint8_t flags[2];
+
+		/**
+		 * @var const uint8_t* ID3v2FrameView::data
+		 *
+		 * @brief Pointer to the frame payload inside the tag bytes.
+		 */
+		const uint8_t* data;
+
+		/**
+		 * @var uint32_t ID3v2FrameView::size
+		 *
+		 * @brief Size of the payload in bytes.
+		 */
+		uint32_t size;
+
+		/**
+		 * @var uint64_t ID3v2FrameView::offset
+		 *
+		 * @brief Offset of the frame header from the beginning of the tag.
+		 */
+		uint64_t offset;
+};
+
+/**
+ * @class ID3v2FrameReader
+ *
+ * @brief Walks the frames of an ID3v2 tag in place, one ID3v2FrameView at a time.
+ *
+ * Handles the 6 byte frame headers of version 2.0, the big-endian frame sizes of version 2.3 and the synchsafe
+ * frame sizes of version 2.4, skips the extended header and stops at the padding or at the first frame that
+ * does not fit in the tag.
+ *
+ * @note Tag level unsynchronization (ID3v2HeaderBase::isUnsynchronized()) must be undone by the caller before.
+ */
+class ID3v2FrameReader{
+	public:
+		/**
+		 * @brief Constructor that reads the tag header.
+		 *
+		 * @param tag Pointer to the tag, starting with "ID3".
+		 * @param size Number of bytes available from tag, header included.
+		 * @param limit Offset the tag cannot go past whatever its header says, such as the file size, or 0 for none.
+		 *              Frames past it are not reported by isTruncated().
+		 */
+		ID3v2FrameReader(const uint8_t* tag, uint64_t size, uint64_t limit = 0);
+
+		/**
+		 * @brief Default virtual destructor.
+		 */
+		virtual ~ID3v2FrameReader();
+
+		/**
+		 * @brief Check if the header is a valid ID3v2.0, ID3v2.3 or ID3v2.4 header.
+		 *
+		 * @return true if valid, false otherwise.
+		 */
+		bool isValid() const;
+
+		/**
+		 * @brief Get the major version of the tag.
+		 *
+		 * @return 2, 3 or 4, or 0 if the header is not valid.
+		 */
+		uint8_t getVersion() const;
+
+		/**
+		 * @brief Read the next frame.
+		 *
+		 * @param view Set to the next frame when found.
+		 *
+		 * @return true if a frame was read, false at the end of the frames.
+		 */
+		bool next(ID3v2FrameView& view);
+
+		/**
+		 * @brief Read all frames from the current position.
+		 *
+		 * @return The views of all remaining frames.
+		 */
+		std::vector<ID3v2FrameView> readAll();
+
+		/**
+		 * @brief Check if the last next() stopped because the available bytes end before the tag does.
+		 *
+		 * @return true if more frames may follow in the bytes not given to the reader, false otherwise.
+		 */
+		bool isTruncated() const;
+
+	private:
+		const uint8_t* tag;	///< Pointer to the tag, starting with "ID3".
+		uint64_t end;		///< Offset of the end of the frames (header + tag size, limited to the available bytes).
+		uint64_t tagEnd;	///< Offset of the end of the frames, header + tag size, limited to the limit if any.
+		uint64_t position;	///< Offset of the next frame header.
+		uint8_t version;	///< Major version of the tag, 0 if not valid.
+		bool truncated;		///< Whether the last next() ran past the available bytes, see isTruncated().
+};
+
+#endif /* ID3V2FRAMEVIEW_HPP */
@@ -0,0 +1,223 @@
+#include "Journal.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+	#include <unistd.h>
+#else
+	#include <io.h>
+#endif
+
+/**
+ * @brief Start of the first line of a journal file, with its format version, followed by the job if any.
+ */
+static const std::string JOURNAL_HEADER = "ID3J\t1";
+
+/**
+ * @brief Escape backslashes, tabs and newlines of a file name so a record stays on one line.
+ */
+static std::string escapeName(const std::string& name){
+	std::string out;
+	for(char character : name){
+		switch(character){
+			case '\\': out += "\\\\"; break;
+			case '\t': out += "\\t"; break;
+			case '\n': out += "\\n"; break;
+			default: out += character; break;
+		}
+	}
+	return out;
+}
+
+/**
+ * @brief Undo escapeName(), false on an unknown escape.
+ */
+static bool unescapeName(const std::string& in, std::string& name){
+	name.clear();
+	for(std::size_t i = 0; i < in.size(); i++){
+		if(in[i] != '\\'){
+			name += in[i];
+			continue;
+		}
+		if(++i == in.size()){
+			return false;
+		}
+		switch(in[i]){
+			case '\\': name += '\\'; break;
+			case 't': name += '\t'; break;
+			case 'n': name += '\n'; break;
+			default: return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Read a decimal field ending at a tab, false if it is empty or not a number.
+ */
+static bool getNumber(const std::string& line, std::size_t& position, uint64_t& value){
+	std::size_t end = line.find('\t', position);
+	if(end == std::string::npos || end == position){
+		return false;
+	}
+	value = 0;
+	for(std::size_t i = position; i < end; i++){
+		if(line[i] < '0' || line[i] > '9'){
+			return false;
+		}
+		value = value * 10 + static_cast<uint64_t>(line[i] - '0');
+	}
+	position = end + 1;
+	return true;
+}
+
+Journal::Journal() :
+	stream(nullptr), pendingCount(0), batchSize(64){
+
+}
+
+Journal::~Journal(){
+	close();
+}
+
+bool Journal::open(const std::filesystem::path& file, bool resume, const std::string& job){
+	close();
+	done.clear();
+	path = file;
+	header = JOURNAL_HEADER + (job.empty() == true ? std::string() : "\t" + escapeName(job)) + "\n";
+
+	if(resume == true && load() == true){
+#ifndef _WIN32
+		stream = std::fopen(path.c_str(), "ab");
+#else
+		stream = _wfopen(path.c_str(), L"ab");
+#endif
+		lastCommit = std::chrono::steady_clock::now();
+		return stream != nullptr;
+	}
+
+	// No usable journal to resume from, every file is done again
+	done.clear();
+#ifndef _WIN32
+	stream = std::fopen(path.c_str(), "wb");
+#else
+	stream = _wfopen(path.c_str(), L"wb");
+#endif
+	if(stream == nullptr){
+		return false;
+	}
+	pending = header;
+	return commit();
+}
+
+void Journal::setBatchSize(std::size_t records){
+	batchSize = records > 0 ? records : 1;
+}
+
+bool Journal::isDone(const std::string& name, const ScanCache::Key& key) const{
+	auto it = done.find(name);
+	return it != done.end() && it->second == key;
+}
+
+bool Journal::markDone(const std::string& name, const ScanCache::Key& key){
+	pending += std::to_string(key.device) + '\t' + std::to_string(key.inode) + '\t' + std::to_string(key.size) + '\t' +
+		std::to_string(static_cast<uint64_t>(key.modified)) + '\t' + escapeName(name) + '\n';
+	pendingCount++;
+
+	if(pendingCount >= batchSize || std::chrono::steady_clock::now() - lastCommit >= std::chrono::seconds(1)){
+		return commit();
+	}
+	return true;
+}
+
+bool Journal::commit(){
+	if(stream == nullptr){
+		return false;
+	}
+
+	bool success = true;
+	if(pending.empty() == false){
+		success = std::fwrite(pending.data(), 1, pending.size(), stream) == pending.size();
+	}
+	success = std::fflush(stream) == 0 && success;
+
+	// syncfs() also flushes the outputs written to the same file system, so no record reaches the disk before its output
+#if defined(__linux__)
+	success = syncfs(fileno(stream)) == 0 && success;
+#elif !defined(_WIN32)
+	success = fsync(fileno(stream)) == 0 && success;
+#else
+	success = _commit(_fileno(stream)) == 0 && success;
+#endif
+
+	pending.clear();
+	pendingCount = 0;
+	lastCommit = std::chrono::steady_clock::now();
+
+	return success;
+}
+
+bool Journal::finish(){
+	close();
+
+	std::error_code error;
+	std::filesystem::remove(path, error);
+	return !error;
+}
+
+std::size_t Journal::getDoneCount() const{
+	return done.size();
+}
+
+bool Journal::load(){
+	std::ifstream input(path, std::ios::in | std::ios::binary);
+	if(input.is_open() == false){
+		return false;
+	}
+	std::string in((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	input.close();
+
+	// The header ends with its newline, so a journal of another job never matches
+	if(in.compare(0, header.size(), header) != 0){
+		return false;
+	}
+
+	// Records are read up to the first one without its newline or damaged, a write torn by a crash
+	std::size_t valid = header.size();
+	for(std::size_t end = in.find('\n', valid); end != std::string::npos; end = in.find('\n', valid)){
+		std::string line = in.substr(valid, end - valid);
+		std::size_t position = 0;
+		uint64_t modified;
+		ScanCache::Key key;
+		std::string name;
+		if(getNumber(line, position, key.device) == false || getNumber(line, position, key.inode) == false ||
+			getNumber(line, position, key.size) == false || getNumber(line, position, modified) == false ||
+			unescapeName(line.substr(position), name) == false){
+			break;
+		}
+		key.modified = static_cast<int64_t>(modified);
+		done[name] = key;
+		valid = end + 1;
+	}
+
+	if(valid < in.size()){
+		std::error_code error;
+		std::filesystem::resize_file(path, valid, error);
+		if(error){
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Journal::close(){
+	if(stream == nullptr){
+		return;
+	}
+	commit();
+	std::fclose(stream);
+	stream = nullptr;
+}
@@ -0,0 +1,129 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+/**
+ * @file Journal.hpp
+ *
+ * @author Evandro L. Vieira
+ *
+ * @brief This file contains the definition of the class Journal.
+ */
+
+#include "ScanCache.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <string>
+
+/**
+ * @class Journal
+ *
+ * @brief Append-only record of the source files a batch job finished, so an interrupted job can resume.
+ *
+ * Each finished file is recorded with its name relative to the source and its ScanCache::Key, so a file changed
+ * since it was recorded is processed again. Records are buffered and committed in batches, every so many records
+ * or at most a second apart: a commit appends them and syncs the file system holding the journal, which also
+ * makes the outputs written next to it durable before the records that claim them. A record torn by a crash is
+ * dropped when the journal is opened again, and its file is redone. The journal can also name the job, such as
+ * its target versions, so the records of another job are never resumed.
+ */
+class Journal{
+	public:
+		/**
+		 * @brief Default constructor, a closed journal committing every 64 records.
+		 */
+		Journal();
+
+		/**
+		 * @brief Virtual destructor that commits the pending records and closes the journal.
+		 */
+		virtual ~Journal();
+
+		/**
+		 * @brief Open a journal file for appending.
+		 *
+		 * @param file The journal file path.
+		 * @param resume true to keep the records of a previous run, false to start an empty journal.
+		 * @param job Settings the records depend on, written in the header. A journal of another job is not
+		 *            resumed, it is started again empty.
+		 *
+		 * @return true if successful, false otherwise.
+		 */
+		bool open(const std::filesystem::path& file, bool resume, const std::string& job = std::string());
+
+		/**
+		 * @brief Set how many records are buffered before a commit.
+		 *
+		 * @param records Number of records, at least 1.
+		 */
+		void setBatchSize(std::size_t records);
+
+		/**
+		 * @brief Check whether a file was finished by a previous run and has not changed since.
+		 *
+		 * @param name The file name relative to the source.
+		 * @param key The current key of the file, see ScanCache::getKey().
+		 *
+		 * @return true if it was finished, false otherwise.
+		 */
+		bool isDone(const std::string& name, const ScanCache::Key& key) const;
+
+		/**
+		 * @brief Record a finished file, committing the batch when it is full or a second old.
+		 *
+		 * @param name The file name relative to the source.
+		 * @param key The key of the file when it was processed.
+		 *
+		 * @return true if successful, false if a commit failed.
+		 */
+		bool markDone(const std::string& name, const ScanCache::Key& key);
+
+		/**
+		 * @brief Append the pending records and sync them to disk.
+		 *
+		 * @return true if successful, false otherwise.
+		 */
+		bool commit();
+
+		/**
+		 * @brief Close and delete the journal once the job is complete.
+		 *
+		 * @return true if successful, false otherwise.
+		 */
+		bool finish();
+
+		/**
+		 * @brief Get the number of files recorded by previous runs.
+		 *
+		 * @return The number of records loaded by open().
+		 */
+		std::size_t getDoneCount() const;
+
+	private:
+		/**
+		 * @brief Read the records of an existing journal and cut off a torn last record.
+		 *
+		 * @return true if the journal has a valid header, false otherwise.
+		 */
+		bool load();
+
+		/**
+		 * @brief Commit the pending records and close the file.
+		 */
+		void close();
+
+	private:
+		std::filesystem::path path;			///< The journal file path.
+		std::string header;					///< First line of the journal, with the job.
+		std::FILE* stream;					///< The open journal, nullptr when closed.
+		std::map<std::string, ScanCache::Key> done;	///< Files finished by previous runs, by name.
+		std::string pending;				///< Records not committed yet.
+		std::size_t pendingCount;			///< Number of records in pending.
+		std::size_t batchSize;				///< Records buffered before a commit.
+		std::chrono::steady_clock::time_point lastCommit;	///< When the last commit happened.
+};
+
+#endif /* JOURNAL_HPP */
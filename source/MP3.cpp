@@ -1,8 +1,6 @@
 #include "MP3.hpp"
 
-#include <stdexcept>
-
-MP3::MP3() : frames() {
+MP3::MP3() : index() {
 }
 
 MP3::~MP3() {
@@ -10,63 +8,46 @@ MP3::~MP3() {
 }
 
 uint32_t MP3::getFrameCount() const {
-	return static_cast<uint32_t>(frames.size());
-}
-
-MP3Frame& MP3::getFrame(uint32_t index) {
-	if (index >= frames.size()) {
-		throw std::out_of_range("Frame index out of range");
-	}
-	return frames[index];
+	return index.getFrameCount();
 }
 
-const MP3Frame& MP3::getFrame(uint32_t index) const {
-	if (index >= frames.size()) {
-		throw std::out_of_range("Frame index out of range");
-	}
-	return frames[index];
+MP3Frame MP3::getFrame(uint32_t frameIndex) const {
+	return index.getFrame(frameIndex);
 }
 
-void MP3::addFrame(const MP3Frame& frame) {
-	frames.push_back(frame);
-}
-
-bool MP3::removeFrame(uint32_t index) {
-	if (index >= frames.size()) {
-		return false;
-	}
-	frames.erase(frames.begin() + index);
-	return true;
+bool MP3::removeFrame(uint32_t frameIndex) {
+	return index.removeFrame(frameIndex);
 }
 
 void MP3::clear() {
-	frames.clear();
+	index.clear();
 }
 
 bool MP3::isEmpty() const {
-	return frames.empty();
+	return index.isEmpty();
 }
 
 double MP3::getTotalDurationMs() const {
-	double totalDuration = 0.0;
-	for (const auto& frame : frames) {
-		totalDuration += frame.getFrameDurationMs();
+	if (index.isEmpty()) {
+		return 0.0;
 	}
-	return totalDuration;
+
+	// The sample rate does not change within a stream, see MP3FrameReader
+	uint32_t sampleRate = index.getHeader(0).getSampleRate();
+	if (sampleRate == 0) {
+		return 0.0;
+	}
+	return static_cast<double>(index.getTotalSamples()) * 1000.0 / sampleRate;
 }
 
 uint64_t MP3::getTotalAudioSize() const {
-	uint64_t totalSize = 0;
-	for (const auto& frame : frames) {
-		totalSize += frame.getTotalFrameSize();
-	}
-	return totalSize;
+	return index.getTotalSize();
 }
 
-const std::vector<MP3Frame>& MP3::getFrames() const {
-	return frames;
+const MP3FrameIndex& MP3::getIndex() const {
+	return index;
 }
 
-std::vector<MP3Frame>& MP3::getFrames() {
-	return frames;
+MP3FrameIndex& MP3::getIndex() {
+	return index;
 }
@@ -10,19 +10,21 @@
  */
 
 #include "MP3Frame.hpp"
+#include "MP3FrameIndex.hpp"
 
 #include <cstdint>
-#include <vector>
 
 /**
  * @class MP3
  *
- * @brief MP3 class containing a sequence of MP3 frames.
+ * @brief MP3 class containing a sequence of MP3 frames, indexed in the buffer that holds them.
+ *
+ * @note The frames are not copied: see MP3FrameIndex, and MP3File::getMP3() which fills it from a loaded file.
  */
 class MP3 {
 	public:
 		/**
-		 * @brief Default constructor that initializes an empty frame list.
+		 * @brief Default constructor that initializes an empty frame index.
 		 */
 		MP3();
 
@@ -39,29 +41,13 @@ class MP3 {
 		uint32_t getFrameCount() const;
 
 		/**
-		 * @brief Get a frame at the given index.
+		 * @brief Get a view of the frame at the given index.
 		 *
 		 * @param index Frame index (0-based).
 		 *
-		 * @return Reference to MP3Frame at index, or throws std::out_of_range if invalid.
-		 */
-		MP3Frame& getFrame(uint32_t index);
-
-		/**
-		 * @brief Get a frame at the given index (const).
-		 *
-		 * @param index Frame index (0-based).
-		 *
-		 * @return Const reference to MP3Frame at index, or throws std::out_of_range if invalid.
-		 */
-		const MP3Frame& getFrame(uint32_t index) const;
-
-		/**
-		 * @brief Add a frame to the sequence.
-		 *
-		 * @param frame Reference to MP3Frame to add.
+		 * @return MP3Frame viewing the indexed buffer, or throws std::out_of_range if invalid.
 		 */
-		void addFrame(const MP3Frame& frame);
+		MP3Frame getFrame(uint32_t index) const;
 
 		/**
 		 * @brief Remove a frame at the given index.
@@ -87,7 +73,7 @@ class MP3 {
 		/**
 		 * @brief Get total audio duration in milliseconds.
 		 *
-		 * @return Duration in milliseconds.
+		 * @return Duration in milliseconds, from the samples of all frames at the sample rate of the first one.
 		 */
 		double getTotalDurationMs() const;
 
@@ -99,26 +85,26 @@ class MP3 {
 		uint64_t getTotalAudioSize() const;
 
 		/**
-		 * @brief Get all frames.
+		 * @brief Get the frame index.
 		 *
-		 * @return Const reference to the frames vector.
+		 * @return Const reference to the index.
 		 */
-		const std::vector<MP3Frame>& getFrames() const;
+		const MP3FrameIndex& getIndex() const;
 
 		/**
-		 * @brief Get all frames (mutable).
+		 * @brief Get the frame index (mutable).
 		 *
-		 * @return Reference to the frames vector.
+		 * @return Reference to the index.
 		 */
-		std::vector<MP3Frame>& getFrames();
+		MP3FrameIndex& getIndex();
 
 	private:
 		/**
-		 * @var std::vector<MP3Frame> MP3::frames
+		 * @var MP3FrameIndex MP3::index
 		 *
-		 * @brief Vector holding all MP3 frames.
+		 * @brief Offsets, headers and sample counts of all MP3 frames.
 		 */
-		std::vector<MP3Frame> frames;
+		MP3FrameIndex index;
 };
 
 #endif /* MP3_HPP */
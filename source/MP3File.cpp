@@ -7,150 +7,852 @@
 
 #include <cstring>
 
+#include <cctype>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#ifdef __linux__
+	#include <cerrno>
+	#include <linux/fs.h>
+	#include <sys/ioctl.h>
+	#include <sys/sendfile.h>
+#endif
+
+#ifdef _WIN32
+	#include <filesystem>
+	#include <fstream>
+#endif
+
 #include <iostream>
 using std::cout;
 using std::endl;
 
-MP3File::MP3File() :
-	File(){
+/**
+ * @brief Bytes read from the end of the file by MP3File::loadTags(), an ID3v1 tag preceded by an ID3v2.4 footer.
+ */
+static const uint64_t TAIL_READ_SIZE = sizeof(ID3v10Data) + 10;
 
-}
+/**
+ * @brief Bytes read from the beginning of the file by MP3File::readFields() before the size of the ID3v2 tag is known.
+ */
+static const uint64_t HEAD_READ_SIZE = 4096;
 
-MP3File::~MP3File(){
+/**
+ * @brief Buffer size of the user space copy used when the kernel can not copy a range between two files.
+ */
+static const uint64_t COPY_BUFFER_SIZE = 1024 * 1024;
 
+/**
+ * @brief Opened file that MP3File::loadTags() and MP3File::saveID3() read and write ranges of.
+ */
+struct TagSource{
+#ifndef _WIN32
+	int descriptor = -1;
+#else
+	std::fstream stream;
+	std::string path;
+#endif
+	uint64_t size = 0;
+};
+
+static bool openTagSource(TagSource& source, const char* filename, bool writable = false){
+#ifndef _WIN32
+	source.descriptor = open(filename, writable == true ? O_RDWR : O_RDONLY);
+	if(source.descriptor < 0){
+		return false;
+	}
+
+	struct stat status;
+	if(fstat(source.descriptor, &status) != 0 || status.st_size <= 0){
+		return false;
+	}
+	source.size = static_cast<uint64_t>(status.st_size);
+#else
+	std::ios::openmode mode = std::ios::in | std::ios::binary | std::ios::ate;
+	if(writable == true){
+		mode |= std::ios::out;
+	}
+
+	source.path = filename;
+	source.stream.open(filename, mode);
+	if(source.stream.is_open() == false){
+		return false;
+	}
+
+	std::streamsize fileSize = source.stream.tellg();
+	if(fileSize <= 0){
+		return false;
+	}
+	source.size = static_cast<uint64_t>(fileSize);
+#endif
+
+	return true;
 }
 
-bool MP3File::hasID3v10() const{
-	if(isEmpty() == true){
+static bool readTagSource(TagSource& source, uint8_t* buffer, uint64_t length, uint64_t offset){
+#ifndef _WIN32
+	while(length > 0){
+		ssize_t count = pread(source.descriptor, buffer, static_cast<std::size_t>(length), static_cast<off_t>(offset));
+		if(count <= 0){
+			return false;
+		}
+		buffer += count;
+		length -= static_cast<uint64_t>(count);
+		offset += static_cast<uint64_t>(count);
+	}
+#else
+	source.stream.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	source.stream.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(length));
+	if(source.stream.fail() == true){
 		return false;
 	}
+#endif
 
-	uint64_t sizeOfID3v10Data = sizeof(ID3v10Data);
-	if(size > sizeOfID3v10Data){
-		uint64_t i = size - sizeOfID3v10Data;
-		bool validLastCommentData = data[i + 126] == 0;
-		if(data[i] == 'T' && data[i + 1] == 'A' && data[i + 2] == 'G' && validLastCommentData == true){
-			return true;
+	return true;
+}
+
+static bool writeTagSource(TagSource& source, const uint8_t* buffer, uint64_t length, uint64_t offset){
+#ifndef _WIN32
+	while(length > 0){
+		ssize_t count = pwrite(source.descriptor, buffer, static_cast<std::size_t>(length), static_cast<off_t>(offset));
+		if(count <= 0){
+			return false;
 		}
+		buffer += count;
+		length -= static_cast<uint64_t>(count);
+		offset += static_cast<uint64_t>(count);
 	}
+#else
+	source.stream.seekp(static_cast<std::streamoff>(offset), std::ios::beg);
+	source.stream.write(reinterpret_cast<const char*>(buffer), static_cast<std::streamsize>(length));
+	if(source.stream.fail() == true){
+		return false;
+	}
+#endif
 
-	return false;
+	return true;
 }
 
-bool MP3File::hasID3v11() const{
-	if(isEmpty() == true){
+/**
+ * @brief Create a new file next to output for spliceTagFile(), never replacing an existing one.
+ */
+static bool createTemporaryTagSource(TagSource& source, const char* output, std::string& temporary){
+	if(File::createTemporary(output, temporary) == false){
 		return false;
 	}
 
-	uint64_t sizeOfID3v11Data = sizeof(ID3v11Data);
-	if(size > sizeOfID3v11Data){
-		uint64_t i = size - sizeOfID3v11Data;
-		bool validLastCommentData = data[i + 125] == 0;
-		bool validTrack = data[i + 126] != 0;
-		if(data[i] == 'T' && data[i + 1] == 'A' && data[i + 2] == 'G' && validLastCommentData == true && validTrack == true){
-			return true;
+#ifndef _WIN32
+	source.descriptor = open(temporary.c_str(), O_RDWR | O_CLOEXEC);
+	if(source.descriptor < 0){
+		std::remove(temporary.c_str());
+		return false;
+	}
+#else
+	source.path = temporary;
+	source.stream.open(temporary, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+	if(source.stream.is_open() == false){
+		std::remove(temporary.c_str());
+		return false;
+	}
+#endif
+	source.size = 0;
+
+	return true;
+}
+
+/**
+ * @brief Get the block size FICLONERANGE needs the offsets of the file aligned to, 0 when it is not available.
+ */
+static uint64_t getCloneBlockSize(const char* filename){
+#if defined(__linux__) && defined(FICLONERANGE)
+	struct stat status;
+	if(stat(filename, &status) == 0 && status.st_blksize > 0){
+		return static_cast<uint64_t>(status.st_blksize);
+	}
+#endif
+	(void)filename;
+	return 0;
+}
+
+static bool copyTagSourceRange(TagSource& from, TagSource& to, uint64_t offset, uint64_t length, uint64_t targetOffset){
+#ifdef __linux__
+	struct stat status;
+	uint64_t blockSize = fstat(to.descriptor, &status) == 0 && status.st_blksize > 0 ? static_cast<uint64_t>(status.st_blksize) : 4096;
+
+#ifdef FICLONERANGE
+	//a reflink shares the blocks, it needs both offsets block aligned and a block multiple length unless it reaches the end of file
+	if(offset % blockSize == 0 && targetOffset % blockSize == 0){
+		uint64_t cloneLength = offset + length == from.size ? length : length - length % blockSize;
+		if(cloneLength > 0){
+			struct file_clone_range range;
+			range.src_fd = from.descriptor;
+			range.src_offset = offset;
+			range.src_length = cloneLength;
+			range.dest_offset = targetOffset;
+			if(ioctl(to.descriptor, FICLONERANGE, &range) == 0){
+				offset += cloneLength;
+				targetOffset += cloneLength;
+				length -= cloneLength;
+			}
 		}
 	}
+#endif
 
-	return false;
+	loff_t input = static_cast<loff_t>(offset);
+	loff_t output = static_cast<loff_t>(targetOffset);
+	while(length > 0){
+		ssize_t count = copy_file_range(from.descriptor, &input, to.descriptor, &output, static_cast<std::size_t>(length), 0);
+		if(count <= 0){
+			break;
+		}
+		length -= static_cast<uint64_t>(count);
+	}
+
+	if(length > 0 && lseek(to.descriptor, output, SEEK_SET) == output){
+		while(length > 0){
+			ssize_t count = sendfile(to.descriptor, from.descriptor, &input, static_cast<std::size_t>(length));
+			if(count <= 0){
+				break;
+			}
+			length -= static_cast<uint64_t>(count);
+		}
+		output = lseek(to.descriptor, 0, SEEK_CUR);
+	}
+
+	offset = static_cast<uint64_t>(input);
+	targetOffset = static_cast<uint64_t>(output);
+#endif
+
+	std::vector<uint8_t> buffer(static_cast<std::size_t>(length < COPY_BUFFER_SIZE ? length : COPY_BUFFER_SIZE));
+	while(length > 0){
+		uint64_t count = length < buffer.size() ? length : buffer.size();
+		if(readTagSource(from, buffer.data(), count, offset) == false || writeTagSource(to, buffer.data(), count, targetOffset) == false){
+			return false;
+		}
+		offset += count;
+		targetOffset += count;
+		length -= count;
+	}
+
+	return true;
 }
 
-bool MP3File::hasID3v20() const{
-	if(isEmpty() == true){
+static void closeTagSource(TagSource& source){
+#ifndef _WIN32
+	if(source.descriptor >= 0){
+		close(source.descriptor);
+		source.descriptor = -1;
+	}
+#else
+	source.stream.close();
+#endif
+}
+
+static bool truncateTagSource(TagSource& source, uint64_t length){
+#ifndef _WIN32
+	return ftruncate(source.descriptor, static_cast<off_t>(length)) == 0;
+#else
+	source.stream.close();
+	std::error_code error;
+	std::filesystem::resize_file(source.path, length, error);
+	return !error;
+#endif
+}
+
+/**
+ * @brief Copy the fields of a 10 byte ID3v2 header into the given header object.
+ */
+static void readID3v2Header(ID3v2HeaderBase& header, const uint8_t* in){
+	std::memcpy(header.tag, in, sizeof(header.tag));
+	header.major_version = in[3];
+	header.revision_number = in[4];
+	header.flags = in[5];
+	std::memcpy(header.size, &in[6], sizeof(header.size));
+}
+
+/**
+ * @brief Copy the frames of an ID3v2.3 or ID3v2.4 tag into the given tag, with one allocation per frame payload,
+ *        or only their headers when source holds a copy of the tag to decode the payloads from later.
+ */
+static void readID3v23Frames(ID3v23& id3v23, const uint8_t* tag, uint64_t tagSize, const std::shared_ptr<const std::vector<uint8_t>>& source){
+	ID3v2FrameReader reader(tag, tagSize);
+	std::vector<ID3v2FrameView> views = reader.readAll();
+
+	id3v23.frames.reserve(views.size());
+	for(const ID3v2FrameView& view : views){
+		id3v23.addFrame(source != nullptr ? view.toID3v23Frame(source) : view.toID3v23Frame());
+	}
+}
+
+/**
+ * @brief Read the ID3v2.3 extended header that follows the tag header, nullptr if it does not fit in the tag.
+ */
+static ID3v23ExtendedHeader* readID3v23ExtendedHeader(const uint8_t* tag, uint64_t tagSize){
+	const uint64_t offset = 10;
+	if(tag == nullptr || offset + 10 > tagSize){
+		return nullptr;
+	}
+
+	const uint8_t* in = &tag[offset];
+	ID3v23ExtendedHeader* extendedHeader = new ID3v23ExtendedHeader();
+	extendedHeader->size = (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16) | (static_cast<uint32_t>(in[2]) << 8) | in[3];
+	extendedHeader->flags = static_cast<uint16_t>((in[4] << 8) | in[5]);
+	extendedHeader->padding = (static_cast<uint32_t>(in[6]) << 24) | (static_cast<uint32_t>(in[7]) << 16) | (static_cast<uint32_t>(in[8]) << 8) | in[9];
+
+	if(extendedHeader->hasCRC() == true){
+		if(offset + 14 > tagSize){
+			delete extendedHeader;
+			return nullptr;
+		}
+		extendedHeader->setCRC((static_cast<uint32_t>(in[10]) << 24) | (static_cast<uint32_t>(in[11]) << 16) | (static_cast<uint32_t>(in[12]) << 8) | in[13]);
+
+		// ID3v23ExtendedHeader::getSize() adds the 4 CRC bytes to ID3v23ExtendedHeader::size
+		if(extendedHeader->size >= 4){
+			extendedHeader->size -= 4;
+		}
+	}
+
+	return extendedHeader;
+}
+
+/**
+ * @brief Copy an unsynchronized ID3v2 tag removing the 0x00 inserted after each 0xFF, the 10 byte header is copied as is.
+ */
+static void resynchronizeID3v2(const uint8_t* tag, uint64_t tagSize, std::vector<uint8_t>& out){
+	out.clear();
+	out.reserve(static_cast<std::size_t>(tagSize));
+	for(uint64_t i = 0; i < tagSize; i++){
+		out.push_back(tag[i]);
+		if(i >= 10 && tag[i] == 0xFF && i + 1 < tagSize && tag[i + 1] == 0x00){
+			i++;
+		}
+	}
+}
+
+/**
+ * @brief ID3v2.4, ID3v2.3 and ID3v2.0 identifiers of the frames that have a field in ID3v1, used by MP3File::readFields().
+ */
+static const struct{
+	const char* id3v24;
+	const char* id3v23;
+	const char* id3v20;
+	int id3v1Field;
+} ID3V1_FIELDS[] = {
+	{"TIT2", "TIT2", "TT2", 0},
+	{"TPE1", "TPE1", "TP1", 1},
+	{"TALB", "TALB", "TAL", 2},
+	{"TDRC", "TYER", "TYE", 3},
+	{"COMM", "COMM", "COM", 4},
+	{"TRCK", "TRCK", "TRK", 5},
+	{"TCON", "TCON", "TCO", 6}
+};
+
+/**
+ * @brief Get the identifier of the given frame in a tag of the given major version, "TIT2" is "TT2" in version 2.0
+ * and the year "TYER" is "TDRC" in version 2.4, a whole timestamp.
+ */
+static std::string toVersionIdentifier(const std::string& identifier, uint8_t version){
+	for(const auto& field : ID3V1_FIELDS){
+		if(identifier == field.id3v24 || identifier == field.id3v23 || identifier == field.id3v20){
+			return version == 2 ? field.id3v20 : version == 4 ? field.id3v24 : field.id3v23;
+		}
+	}
+	return identifier;
+}
+
+/**
+ * @brief Get the ID3v1 value of the given frame identifier from an ID3v1.1 or ID3v1.0 tag, false if ID3v1 has no such field.
+ */
+static bool readID3v1Field(const ID3v1& v1, bool isID3v11, const std::string& identifier, std::string& value){
+	int id3v1Field = -1;
+	for(const auto& field : ID3V1_FIELDS){
+		if(identifier == field.id3v24 || identifier == field.id3v23 || identifier == field.id3v20){
+			id3v1Field = field.id3v1Field;
+			break;
+		}
+	}
+	if(id3v1Field < 0){
 		return false;
 	}
 
-	if(size >= 5 && data[0] == 'I' && data[1] == 'D' && data[2] == '3' && data[3] == 2 && data[4] == 0){
-		return true;
+	if(isID3v11 == true){
+		switch(id3v1Field){
+			case 0: value = v1.v11->getTitle(); break;
+			case 1: value = v1.v11->getArtist(); break;
+			case 2: value = v1.v11->getAlbum(); break;
+			case 3: value = v1.v11->getYear(); break;
+			case 4: value = v1.v11->getComment(); break;
+			case 5: value = std::to_string(v1.v11->getTrack()); break;
+			default: value = std::to_string(static_cast<int>(v1.v11->getGenre())); break;
+		}
 	}else{
+		switch(id3v1Field){
+			case 0: value = v1.v10->getTitle(); break;
+			case 1: value = v1.v10->getArtist(); break;
+			case 2: value = v1.v10->getAlbum(); break;
+			case 3: value = v1.v10->getYear(); break;
+			case 4: value = v1.v10->getComment(); break;
+			case 5: return false;
+			default: value = std::to_string(static_cast<int>(v1.v10->getGenre())); break;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Set the fields of the given frame for each wanted identifier it matches and that is not set yet.
+ *
+ * @return The number of fields set.
+ */
+static std::size_t readID3v2Field(const ID3v2FrameView& view, const std::vector<std::string>& identifiers, const std::vector<std::string>& wanted, std::map<std::string, std::string>& fields){
+	std::size_t found = 0;
+	std::string identifier = view.getIdentifier();
+	for(std::size_t i = 0; i < wanted.size(); i++){
+		if(wanted[i] == identifier && fields.count(identifiers[i]) == 0){
+			ID3v23Frame* frame = view.version == 2 ? nullptr : view.toID3v23Frame();
+			if(frame != nullptr){
+				uint8_t* payload = frame->getData();
+				fields[identifiers[i]] = std::string(reinterpret_cast<char*>(payload), frame->header.getFrameSize());
+				delete frame;
+			}else{
+				fields[identifiers[i]] = std::string(reinterpret_cast<const char*>(view.data), view.size);
+			}
+			found++;
+		}
+	}
+	return found;
+}
+
+/**
+ * @brief Write head, the audio range of filename and tail into a temporary file renamed over output afterwards.
+ */
+static bool spliceTagFile(const char* filename, const char* output, const std::vector<uint8_t>& head, uint64_t audioOffset, uint64_t audioSize, const uint8_t* tail, uint64_t tailSize){
+	TagSource source;
+	if(openTagSource(source, filename) == false){
+		closeTagSource(source);
 		return false;
 	}
+
+	std::string temporary;
+	TagSource target;
+	if(createTemporaryTagSource(target, output, temporary) == false){
+		closeTagSource(source);
+		closeTagSource(target);
+		return false;
+	}
+
+#ifndef _WIN32
+	struct stat status;
+	if(fstat(source.descriptor, &status) == 0){
+		fchmod(target.descriptor, status.st_mode & 07777);
+	}
+#endif
+
+	bool success = true;
+	if(head.empty() == false){
+		success = writeTagSource(target, head.data(), head.size(), 0);
+	}
+	success = success && copyTagSourceRange(source, target, audioOffset, audioSize, head.size());
+	if(tailSize > 0){
+		success = success && writeTagSource(target, tail, tailSize, head.size() + audioSize);
+	}
+
+#ifndef _WIN32
+	//replacing the file itself: the new content must be on disk before the rename makes it visible, or a crash could leave it empty
+	bool inPlace = std::string(output) == filename;
+	if(success == true && inPlace == true){
+		success = fsync(target.descriptor) == 0;
+	}
+#endif
+
+	closeTagSource(source);
+	closeTagSource(target);
+
+	if(success == true){
+#ifndef _WIN32
+		success = std::rename(temporary.c_str(), output) == 0;
+		//and the rename itself must reach the directory, or a crash could bring the old file back
+		if(success == true && inPlace == true){
+			File::syncParentDirectory(output);
+		}
+#else
+		std::error_code error;
+		std::filesystem::rename(temporary, output, error);
+		success = !error;
+#endif
+	}
+
+	if(success == false){
+		std::remove(temporary.c_str());
+	}
+
+	return success;
 }
 
-bool MP3File::hasID3v23() const{
-	if(isEmpty() == true){
+MP3File::MP3File() :
+	File(), tagsOnly(false), fileSize(0), paddingMinimum(1024), paddingAlignment(0), probed(false), lazyFrames(false){
+
+}
+
+MP3File::~MP3File(){
+
+}
+
+void MP3File::clear(){
+	File::clear();
+	tagsOnly = false;
+	fileSize = 0;
+	probed = false;
+	resynchronized.clear();
+}
+
+bool MP3File::loadTags(const char* filename){
+	if(isEmpty() == false){
 		return false;
 	}
 
-	if(size >= 5 && data[0] == 'I' && data[1] == 'D' && data[2] == '3' && data[3] == 3 && data[4] == 0){
-		return true;
-	}else{
+	TagSource source;
+	if(openTagSource(source, filename) == false){
+		closeTagSource(source);
 		return false;
 	}
+
+	uint8_t header[10] = {0};
+	uint64_t headSize = source.size < sizeof(header) ? source.size : sizeof(header);
+	if(readTagSource(source, header, headSize, 0) == false){
+		closeTagSource(source);
+		return false;
+	}
+
+	bool hasID3v2Header = headSize == sizeof(header) && header[0] == 'I' && header[1] == 'D' && header[2] == '3';
+	if(hasID3v2Header == true && header[3] >= 2 && header[3] <= 4){
+		ID3v2HeaderBase tagHeader;
+		std::memcpy(tagHeader.size, &header[6], 4);
+
+		bool hasFooter = header[3] == 4 && (header[5] & 0x10) != 0;
+		headSize += tagHeader.getTagSize() + (hasFooter == true ? 10 : 0);
+		if(headSize > source.size){
+			headSize = source.size;
+		}
+	}
+
+	uint64_t tailSize = source.size - headSize;
+	if(tailSize > TAIL_READ_SIZE){
+		tailSize = TAIL_READ_SIZE;
+	}
+
+	uint8_t* image = new uint8_t[static_cast<std::size_t>(headSize + tailSize)];
+	std::memcpy(image, header, static_cast<std::size_t>(headSize < sizeof(header) ? headSize : sizeof(header)));
+
+	bool success = true;
+	if(headSize > sizeof(header)){
+		success = readTagSource(source, &image[sizeof(header)], headSize - sizeof(header), sizeof(header));
+	}
+	if(success == true && tailSize > 0){
+		success = readTagSource(source, &image[headSize], tailSize, source.size - tailSize);
+	}
+	closeTagSource(source);
+
+	if(success == false){
+		delete[] image;
+		return false;
+	}
+
+	data = image;
+	size = headSize + tailSize;
+	fileSize = source.size;
+	tagsOnly = size < fileSize;
+
+	return true;
 }
 
-bool MP3File::hasID3v24() const{
-	if(isEmpty() == true){
+bool MP3File::isMP3File(const std::string& filename){
+	if(filename.size() < 4){
 		return false;
 	}
+	std::string extension = filename.substr(filename.size() - 4);
+	for(char& c : extension){
+		c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+	return extension == ".mp3";
+}
 
-	if(size >= 5 && data[0] == 'I' && data[1] == 'D' && data[2] == '3' && data[3] == 4 && data[4] == 0){
-		return true;
-	}else{
+bool MP3File::readFields(const char* filename, const std::vector<std::string>& identifiers, std::map<std::string, std::string>& fields){
+	fields.clear();
+
+	TagSource source;
+	if(openTagSource(source, filename) == false){
+		closeTagSource(source);
 		return false;
 	}
+
+	// The frames wanted are usually at the start of the tag, so read a fixed head first and the rest only if needed
+	std::vector<uint8_t> head(static_cast<std::size_t>(source.size < HEAD_READ_SIZE ? source.size : HEAD_READ_SIZE));
+	if(readTagSource(source, head.data(), head.size(), 0) == false){
+		closeTagSource(source);
+		return false;
+	}
+
+	std::size_t remaining = identifiers.size();
+	ID3v2FrameReader reader(head.data(), head.size(), source.size);
+	if(reader.isValid() == true){
+		uint64_t tagSize = 10 + ((head[6] & 0x7F) << 21 | (head[7] & 0x7F) << 14 | (head[8] & 0x7F) << 7 | (head[9] & 0x7F));
+		if(tagSize > source.size){
+			tagSize = source.size;
+		}
+
+		bool isUnsynchronized = reader.getVersion() != 4 && (head[5] & 0x80) != 0;
+		std::vector<uint8_t> resynchronizedHead;
+		if(isUnsynchronized == true || tagSize <= head.size()){
+			// Unsynchronized sizes can only be read after resynchronizing the whole tag
+			if(tagSize > head.size()){
+				std::size_t headSize = head.size();
+				head.resize(static_cast<std::size_t>(tagSize));
+				if(readTagSource(source, &head[headSize], tagSize - headSize, headSize) == false){
+					closeTagSource(source);
+					return false;
+				}
+			}
+			if(isUnsynchronized == true){
+				resynchronizeID3v2(head.data(), tagSize, resynchronizedHead);
+				head.swap(resynchronizedHead);
+			}
+			// The head now holds the whole tag, nothing past it can be read again
+			reader = ID3v2FrameReader(head.data(), head.size(), head.size());
+		}
+
+		std::vector<std::string> wanted;
+		wanted.reserve(identifiers.size());
+		for(const std::string& identifier : identifiers){
+			wanted.push_back(toVersionIdentifier(identifier, reader.getVersion()));
+		}
+
+		ID3v2FrameView view;
+		while(remaining > 0){
+			if(reader.next(view) == false){
+				// The whole tag the file holds is already read when the header declares a larger one
+				if(reader.isTruncated() == false || head.size() >= tagSize){
+					break;
+				}
+
+				// A frame goes past the head, read the rest of the tag and walk it again from the beginning
+				std::size_t headSize = head.size();
+				head.resize(static_cast<std::size_t>(tagSize));
+				if(readTagSource(source, &head[headSize], tagSize - headSize, headSize) == false){
+					closeTagSource(source);
+					return false;
+				}
+				reader = ID3v2FrameReader(head.data(), head.size(), tagSize);
+				continue;
+			}
+
+			remaining -= readID3v2Field(view, identifiers, wanted, fields);
+		}
+	}
+
+	// The ID3v1 tail is only read for the fields the ID3v2 tag did not have
+	if(remaining > 0 && source.size > sizeof(ID3v10Data)){
+		uint8_t tail[sizeof(ID3v10Data)];
+		if(readTagSource(source, tail, sizeof(tail), source.size - sizeof(tail)) == true && tail[0] == 'T' && tail[1] == 'A' && tail[2] == 'G'){
+			readID3v1Fields(tail, identifiers, fields);
+		}
+	}
+
+	closeTagSource(source);
+
+	return true;
+}
+
+void MP3File::getFields(const std::vector<std::string>& identifiers, std::map<std::string, std::string>& fields) const{
+	fields.clear();
+
+	uint64_t tagSize = 0;
+	const uint8_t* tag = getID3v2Bytes(tagSize);
+
+	std::size_t remaining = identifiers.size();
+	ID3v2FrameReader reader(tag, tagSize);
+	if(reader.isValid() == true){
+		std::vector<std::string> wanted;
+		wanted.reserve(identifiers.size());
+		for(const std::string& identifier : identifiers){
+			wanted.push_back(toVersionIdentifier(identifier, reader.getVersion()));
+		}
+
+		ID3v2FrameView view;
+		while(remaining > 0 && reader.next(view) == true){
+			remaining -= readID3v2Field(view, identifiers, wanted, fields);
+		}
+	}
+
+	// The ID3v1 tag is the end of the data, also when only the tags were loaded
+	if(remaining > 0 && getTagProbe().hasID3v1() == true){
+		readID3v1Fields(data + size - sizeof(ID3v10Data), identifiers, fields);
+	}
+}
+
+bool MP3File::isTagsOnly() const{
+	return tagsOnly;
+}
+
+uint64_t MP3File::getFileSize() const{
+	if(tagsOnly == true){
+		return fileSize;
+	}
+	return size;
+}
+
+bool MP3File::save(const char* filename){
+	if(tagsOnly == true){
+		return false;
+	}
+	return File::save(filename);
+}
+
+bool MP3File::saveWithoutTags(const char* filename, bool removeID3v1, bool removeID3v2) const{
+	if(isEmpty() == true || tagsOnly == true){
+		return false;
+	}
+
+	// Same bytes as setID3() with the tag cleared: the ID3v1 tag is the last 128 bytes, the ID3v2 tag the first ones
+	const TagProbe& probe = getTagProbe();
+	uint64_t begin = removeID3v2 == true ? probe.id3v2Size : 0;
+	uint64_t end = removeID3v1 == true && probe.hasID3v1() == true ? size - sizeof(ID3v10Data) : size;
+	if(begin > end){
+		begin = end;
+	}
+
+	return saveRange(filename, begin, end - begin);
+}
+
+bool MP3File::saveWithoutTags(const char* filename, const char* output, bool removeID3v1, bool removeID3v2) const{
+	if(isEmpty() == true){
+		return false;
+	}
+
+	const TagProbe& probe = getTagProbe();
+	uint64_t begin = removeID3v2 == true ? probe.id3v2Size : 0;
+	uint64_t end = removeID3v1 == true && probe.hasID3v1() == true ? probe.fileSize - sizeof(ID3v10Data) : probe.fileSize;
+	if(begin > end){
+		begin = end;
+	}
+
+	//the ID3v1 tag is the end of the file, cutting only it leaves every other byte where it is
+	if(begin == 0 && std::string(output) == filename){
+		TagSource target;
+		if(openTagSource(target, filename, true) == false || target.size != probe.fileSize){
+			closeTagSource(target);
+			return false;
+		}
+		bool success = end == probe.fileSize || truncateTagSource(target, end);
+		closeTagSource(target);
+		return success;
+	}
+
+	return spliceTagFile(filename, output, std::vector<uint8_t>(), begin, end - begin, nullptr, 0);
+}
+
+const TagProbe& MP3File::getTagProbe() const{
+	if(probed == false){
+		tagProbe.probe(data, size, getFileSize());
+		probed = true;
+	}
+	return tagProbe;
+}
+
+bool MP3File::hasID3v10() const{
+	return getTagProbe().has(TagProbe::ID3v10);
+}
+
+bool MP3File::hasID3v11() const{
+	return getTagProbe().has(TagProbe::ID3v11);
+}
+
+bool MP3File::hasID3v20() const{
+	return getTagProbe().has(TagProbe::ID3v20);
+}
+
+bool MP3File::hasID3v23() const{
+	return getTagProbe().has(TagProbe::ID3v23);
+}
+
+bool MP3File::hasID3v24() const{
+	return getTagProbe().has(TagProbe::ID3v24);
 }
 
 ID3 MP3File::getID3() const{
 	ID3 id3;
 
 	if(isEmpty() == false){
-		if(hasID3v11() == true){
-			int sizeOfID3v11Data = sizeof(ID3v11Data);
+		const TagProbe& probe = getTagProbe();
+		uint64_t sizeOfID3v1Data = sizeof(ID3v10Data);
+
+		if(probe.has(TagProbe::ID3v11) == true){
 			ID3v11* v11 = new ID3v11();
-			std::memcpy(&v11->data, &data[size - sizeOfID3v11Data], sizeOfID3v11Data);
+			std::memcpy(&v11->data, &data[size - sizeOfID3v1Data], sizeOfID3v1Data);
 			id3.v1.v11 = v11;
-		}else if(hasID3v10() == true){
-			int sizeOfID3v10Data = sizeof(ID3v10Data);
+		}else if(probe.has(TagProbe::ID3v10) == true){
 			ID3v10* v10 = new ID3v10();
-			std::memcpy(&v10->data, &data[size - sizeOfID3v10Data], sizeOfID3v10Data);
+			std::memcpy(&v10->data, &data[size - sizeOfID3v1Data], sizeOfID3v1Data);
 			id3.v1.v10 = v10;
 		}
 
-		if(hasID3v24() == true){
-			ID3v24* v24 = new ID3v24();
-			//std::memcpy(&v24->header, data, sizeof(ID3v2HeaderBase));
-			v24->header = *reinterpret_cast<ID3v24Header*>(data);
-
-			id3.v2.v24 = v24;
-		}else if(hasID3v23() == true){
-			ID3v23* v23 = new ID3v23();
-			//std::memcpy(&v23->header, data, sizeof(ID3v2HeaderBase));
-			v23->header = *reinterpret_cast<ID3v23Header*>(data);
-
-			id3.v2.v23 = v23;
-		}else if(hasID3v20() == true){
-			ID3v20* v20 = new ID3v20();
-			//std::memcpy(&v20->header, data, sizeof(ID3v2HeaderBase));
-			v20->header = *reinterpret_cast<ID3v20Header*>(data);
+		uint64_t tagSize = 0;
+		const uint8_t* tag = getID3v2Bytes(tagSize);
 
-			id3.v2.v20 = v20;
+		// Lazy frames share one copy of the tag, so they outlive the loaded data
+		std::shared_ptr<const std::vector<uint8_t>> source;
+		if(lazyFrames == true && tag != nullptr){
+			source = std::make_shared<const std::vector<uint8_t>>(tag, tag + tagSize);
+			tag = source->data();
+		}
 
-		uint32_t tagSize = v20->header.getTagSize();
+		if(probe.has(TagProbe::ID3v24) == true){
+			ID3v24* v24 = new ID3v24();
+			readID3v2Header(v24->header, data);
 
-			// Determine the position where frames start after the header
-			uint32_t headerBaseSize = sizeof(ID3v2HeaderBase);
-			uint32_t currentPosition = headerBaseSize;
+			// The extended header is skipped by ID3v2FrameReader and not kept, ID3v23ExtendedHeader has the version 2.3 layout
+			v24->header.setExtendedHeader(false);
+			readID3v23Frames(*v24, tag, tagSize, source);
 
-			// Iterate through frames until the end of data
-			while(currentPosition < tagSize){
-				ID3v20Frame* frame = new ID3v20Frame();
+			if(probe.has(TagProbe::ID3v24Footer) == true){
+				v24->readFooter(&data[probe.id3v2Size - 10]);
+			}
 
-				// Read frame header
-				//std::memcpy(&frame->header, &data[currentPosition], sizeof(ID3v20FrameHeader));
-				frame->header = *reinterpret_cast<ID3v20FrameHeader*>(&data[currentPosition]);
-				currentPosition += sizeof(ID3v20FrameHeader);
+			id3.v2.v24 = v24;
+		}else if(probe.has(TagProbe::ID3v23) == true){
+			ID3v23* v23 = new ID3v23();
+			readID3v2Header(v23->header, data);
 
-				// Determine frame size and allocate memory for frame data
-				uint32_t frameSize = frame->header.getFrameSize();
-				frame->data = new uint8_t[frameSize];
+			// Frames are kept resynchronized, see getID3v2Bytes()
+			v23->header.setUnsynchronized(false);
+			if(v23->header.hasExtendedHeader() == true){
+				v23->extendedHeader = readID3v23ExtendedHeader(tag, tagSize);
+				if(v23->extendedHeader == nullptr){
+					v23->header.setExtendedHeader(false);
+				}
+			}
+			readID3v23Frames(*v23, tag, tagSize, source);
 
-				// Read frame data
-				std::memcpy(frame->data, &data[currentPosition], frameSize);
-				currentPosition += frameSize;
+			id3.v2.v23 = v23;
+		}else if(probe.has(TagProbe::ID3v20) == true){
+			ID3v20* v20 = new ID3v20();
+			readID3v2Header(v20->header, data);
+			v20->header.setUnsynchronized(false);
 
-				// Store frame in ID3v20 object
-				v20->frames.push_back(frame);
+			ID3v2FrameReader reader(tag, tagSize);
+			std::vector<ID3v2FrameView> views = reader.readAll();
+			v20->frames.reserve(views.size());
+			for(const ID3v2FrameView& view : views){
+				v20->addFrame(source != nullptr ? view.toID3v20Frame(source) : view.toID3v20Frame());
 			}
 
 			id3.v2.v20 = v20;
@@ -161,42 +863,38 @@ ID3 MP3File::getID3() const{
 }
 
 void MP3File::setID3(const ID3& id3){
-	if(isEmpty() == true){
+	if(isEmpty() == true || tagsOnly == true){
 		return;
 	}
 
 	ID3v10* id3v10 = id3.v1.v10;
 	ID3v11* id3v11 = id3.v1.v11;
 
-	if(id3v11 != nullptr){
-		uint64_t sizeOfID3v11Data = sizeof(ID3v11Data);
-		uint64_t newSize = size + sizeOfID3v11Data;
-		uint8_t* newData = new uint8_t[newSize];
-
-		std::memcpy(newData, data, size);
-		std::memcpy(&newData[size - 1], &id3v11->data, sizeOfID3v11Data);
+	uint64_t sizeOfID3v1Data = sizeof(ID3v10Data);
+	bool hasID3v1Tag = getTagProbe().hasID3v1();
+	uint64_t oldID3v2Size = getTagProbe().id3v2Size;
 
-		clear();
+	if(id3v11 != nullptr || id3v10 != nullptr){
+		const void* tagData = id3v11 != nullptr ? static_cast<const void*>(&id3v11->data) : static_cast<const void*>(&id3v10->data);
 
-		data = newData;
-		size = newSize;
-	}else if(id3v10 != nullptr){
-		uint64_t sizeOfID3v10Data = sizeof(ID3v10Data);
-		uint64_t newSize = size + sizeOfID3v10Data;
-		uint8_t* newData = new uint8_t[newSize];
+		if(hasID3v1Tag == true){
+			std::memcpy(&data[size - sizeOfID3v1Data], tagData, sizeOfID3v1Data);
+		}else{
+			uint64_t newSize = size + sizeOfID3v1Data;
+			uint8_t* newData = new uint8_t[newSize];
 
-		std::memcpy(newData, data, size);
-		std::memcpy(&newData[size - 1], &id3v10->data, sizeOfID3v10Data);
+			std::memcpy(newData, data, size);
+			std::memcpy(&newData[size], tagData, sizeOfID3v1Data);
 
-		clear();
+			clear();
 
-		data = newData;
-		size = newSize;
+			data = newData;
+			size = newSize;
+		}
 	}else{
 		//removing id3 v10 or v11 from 'data'
-		if(hasID3v10() == true || hasID3v11() == true){
-			uint64_t sizeOfID3v10Data = sizeof(ID3v10Data);
-			uint64_t newSize = size - sizeOfID3v10Data;
+		if(hasID3v1Tag == true){
+			uint64_t newSize = size - sizeOfID3v1Data;
 			uint8_t* newData = new uint8_t[newSize];
 
 			std::memcpy(newData, data, newSize);
@@ -208,28 +906,354 @@ void MP3File::setID3(const ID3& id3){
 		}
 	}
 
-	ID3v20* id3v20 = id3.v2.v20;
-	ID3v23* id3v23 = id3.v2.v23;
-	ID3v24* id3v24 = id3.v2.v24;
+	std::vector<uint8_t> tag = renderID3v2(id3.v2, oldID3v2Size);
 
-	if(id3v24 != nullptr){
-		//TODO set ID3 v24 tag to 'data'
-	}else if(id3v23 != nullptr){
-		//TODO set ID3 v23 tag to 'data'
-	}else if(id3v20 != nullptr){
-		//TODO set ID3 v20 tag to 'data'
+	if(tag.size() == oldID3v2Size){
+		//the new tag reuses the bytes of the old one, frames plus padding
+		if(tag.empty() == false){
+			std::memcpy(data, tag.data(), tag.size());
+		}
+		probed = false;
+		resynchronized.clear();
 	}else{
-		if(hasID3v20() == true){
-			//TODO remove ID3 v20 from 'data'
+		uint64_t newSize = size - oldID3v2Size + tag.size();
+		uint8_t* newData = new uint8_t[newSize];
+
+		if(tag.empty() == false){
+			std::memcpy(newData, tag.data(), tag.size());
 		}
+		std::memcpy(&newData[tag.size()], &data[oldID3v2Size], size - oldID3v2Size);
 
-		if(hasID3v23() == true){
-			//TODO remove ID3 v23 from 'data'
+		clear();
+
+		data = newData;
+		size = newSize;
+	}
+}
+
+bool MP3File::saveID3(const char* filename, const ID3& id3, const char* output){
+	if(isEmpty() == true){
+		return false;
+	}
+
+	const TagProbe& probe = getTagProbe();
+	uint64_t diskSize = probe.fileSize;
+	uint64_t oldID3v2Size = probe.id3v2Size;
+	bool hasID3v1Tag = probe.hasID3v1();
+
+	std::vector<uint8_t> tag = renderID3v2(id3.v2, oldID3v2Size);
+
+	//an ID3v2 tag unchanged from the loaded one keeps its bytes, extended header, flags and frame order included
+	if(oldID3v2Size > 0 && oldID3v2Size <= size){
+		ID3 loaded = getID3();
+		if(renderID3v2(loaded.v2, oldID3v2Size) == tag){
+			tag.assign(data, data + oldID3v2Size);
 		}
+	}
+
+	//a grown tag is padded so the audio keeps its offset within a file system block, or FICLONERANGE could never share its blocks
+	uint64_t cloneBlockSize = paddingAlignment == 0 ? getCloneBlockSize(filename) : 0;
+	if(tag.size() > oldID3v2Size && cloneBlockSize > 0){
+		uint64_t shift = (oldID3v2Size % cloneBlockSize + cloneBlockSize - tag.size() % cloneBlockSize) % cloneBlockSize;
+		tag = renderID3v2(id3.v2, tag.size() + shift);
+	}
+
+	uint64_t sizeOfID3v1Data = sizeof(ID3v10Data);
+	const uint8_t* tagData = nullptr;
+	if(id3.v1.v11 != nullptr){
+		tagData = reinterpret_cast<const uint8_t*>(&id3.v1.v11->data);
+	}else if(id3.v1.v10 != nullptr){
+		tagData = reinterpret_cast<const uint8_t*>(&id3.v1.v10->data);
+	}
 
-		if(hasID3v24() == true){
-			//TODO remove ID3 v24 from 'data'
+	bool inPlace = output == nullptr || std::string(output) == filename;
+	if(tag.size() != oldID3v2Size || inPlace == false){
+		//the audio moves or goes to another file: splice it behind the new tag, never through this buffer
+		uint64_t audioEnd = hasID3v1Tag == true ? diskSize - sizeOfID3v1Data : diskSize;
+		uint64_t audioSize = audioEnd > oldID3v2Size ? audioEnd - oldID3v2Size : 0;
+
+		//written to another file the source is unchanged, the loaded data stays valid for further outputs
+		if(inPlace == true){
+			clear();
 		}
+
+		return spliceTagFile(filename, inPlace == true ? filename : output, tag, oldID3v2Size, audioSize, tagData, tagData != nullptr ? sizeOfID3v1Data : 0);
+	}
+
+	TagSource target;
+	if(openTagSource(target, filename, true) == false || target.size != diskSize){
+		closeTagSource(target);
+		return false;
+	}
+
+	//bytes already on disk are not written again, removing only the ID3v1 tag is then a single truncate
+	bool success = true;
+	if(tag.empty() == false && std::memcmp(tag.data(), data, tag.size()) != 0){
+		success = writeTagSource(target, tag.data(), tag.size(), 0);
+	}
+
+	if(tagData != nullptr){
+		uint64_t offset = hasID3v1Tag == true ? diskSize - sizeOfID3v1Data : diskSize;
+		if(hasID3v1Tag == false || std::memcmp(tagData, &data[size - sizeOfID3v1Data], sizeOfID3v1Data) != 0){
+			success = success && writeTagSource(target, tagData, sizeOfID3v1Data, offset);
+		}
+	}else if(hasID3v1Tag == true){
+		success = success && truncateTagSource(target, diskSize - sizeOfID3v1Data);
+	}
+
+	closeTagSource(target);
+	clear();
+
+	return success;
+}
+
+void MP3File::setLazyFrames(bool lazy){
+	lazyFrames = lazy;
+}
+
+void MP3File::setPaddingPolicy(uint32_t minimum, uint32_t alignment){
+	paddingMinimum = minimum;
+	paddingAlignment = alignment;
+}
+
+uint64_t MP3File::getID3v2Size() const{
+	return getTagProbe().id3v2Size;
+}
+
+const uint8_t* MP3File::getID3v1Bytes() const{
+	if(isEmpty() == true || getTagProbe().hasID3v1() == false){
+		return nullptr;
+	}
+	// The ID3v1 tag is the end of the data, also when only the tags were loaded
+	return &data[size - sizeof(ID3v10Data)];
+}
+
+std::vector<ID3v2FrameView> MP3File::getFrameViews() const{
+	uint64_t tagSize = 0;
+	const uint8_t* tag = getID3v2Bytes(tagSize);
+
+	ID3v2FrameReader reader(tag, tagSize);
+	return reader.readAll();
+}
+
+bool MP3File::getFrameView(const char* identifier, ID3v2FrameView& view) const{
+	uint64_t tagSize = 0;
+	const uint8_t* tag = getID3v2Bytes(tagSize);
+
+	ID3v2FrameReader reader(tag, tagSize);
+	while(reader.next(view) == true){
+		if(view.isIdentifier(identifier) == true){
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool MP3File::getMP3(MP3& mp3) const{
+	mp3.clear();
+	uint64_t start = 0;
+	uint64_t end = 0;
+	if(getAudioRange(start, end) == false){
+		return false;
+	}
+	if(start >= end){
+		return true;
+	}
+
+	// Offsets are kept from the start of the file, so they stay valid as file offsets
+	MP3FrameIndex& index = mp3.getIndex();
+	index.reset(data);
+	MP3FrameReader reader(&data[start], end - start);
+	uint64_t offset = 0;
+	MP3FrameHeader header;
+	while(reader.next(offset, header) == true){
+		// The size of the first frame, without padding, gives a little more than the frame count of a constant bitrate file
+		if(index.isEmpty() == true){
+			index.reserve(static_cast<uint32_t>((end - start) / (header.getFrameSize() - (header.hasPadding() == true ? 1 : 0)) + 1));
+		}
+		index.addFrame(start + offset);
+	}
+
+	return true;
+}
+
+bool MP3File::getStreamInfo(MP3StreamInfo& info) const{
+	info = MP3StreamInfo();
+	uint64_t start = 0;
+	uint64_t end = 0;
+	if(getAudioRange(start, end) == false){
+		return false;
+	}
+	if(start >= end){
+		return true;
+	}
+
+	MP3FrameReader reader(&data[start], end - start);
+	uint64_t offset = 0;
+	MP3FrameHeader header;
+	if(reader.next(offset, header) == false){
+		return true;
+	}
+	info.firstFrame = header;
+	info.audioOffset = start + offset;
+	info.audioSize = end - info.audioOffset;
+	info.sampleRate = header.getSampleRate();
+	uint16_t samplesPerFrame = header.getSamplesPerFrame();
+	uint64_t headerFrameSize = header.getFrameSize() < info.audioSize ? header.getFrameSize() : info.audioSize;
+	bool hasVBRHeader = info.vbrHeader.parse(&data[info.audioOffset], headerFrameSize) == true;
+	uint64_t trimmed = info.vbrHeader.hasEncoderDelay() == true ? static_cast<uint64_t>(info.vbrHeader.getEncoderDelay()) + info.vbrHeader.getEncoderPadding() : 0;
+	if(info.sampleRate == 0 || samplesPerFrame == 0){
+		return true;
+	}
+
+	if(hasVBRHeader == true && info.vbrHeader.hasFrameCount() == true){
+		// The header frame holds no audio and is not counted
+		info.source = MP3StreamInfo::VBRHeader;
+		info.frameCount = info.vbrHeader.getFrameCount();
+		uint64_t bytes = info.vbrHeader.hasByteCount() == true ? info.vbrHeader.getByteCount() : info.audioSize;
+		uint64_t samples = info.frameCount * samplesPerFrame;
+		info.sampleCount = samples > trimmed ? samples - trimmed : 0;
+		info.durationMs = info.sampleCount * 1000.0 / info.sampleRate;
+		info.averageBitrate = info.durationMs > 0 ? static_cast<uint32_t>(bytes * 8 / info.durationMs + 0.5) : 0;
+		return true;
+	}
+
+	// A header frame without frame count holds no audio either, the bitrate is checked from the next frame
+	uint64_t audioStart = info.audioOffset;
+	if(hasVBRHeader == true){
+		audioStart += headerFrameSize;
+		if(reader.next(offset, header) == false){
+			return true;
+		}
+	}
+
+	// Constant bitrate if the next frames share the bitrate and sample rate, the frame count is then an estimate
+	static const int CBR_CHECKED_FRAMES = 16;
+	uint16_t bitrate = header.getBitrate();
+	bool isConstant = bitrate > 0;
+	MP3FrameHeader next;
+	for(int i = 0; i < CBR_CHECKED_FRAMES && isConstant == true; i++){
+		isConstant = reader.next(offset, next) == true && next.getBitrate() == bitrate && next.getSampleRate() == info.sampleRate;
+	}
+	if(isConstant == true && reader.getResyncCount() == 0){
+		uint64_t bytes = end - audioStart;
+		double bytesPerFrame = samplesPerFrame * bitrate * 125.0 / info.sampleRate;
+		info.source = MP3StreamInfo::ConstantBitrate;
+		info.frameCount = static_cast<uint64_t>(bytes / bytesPerFrame + 0.5);
+		uint64_t samples = info.frameCount * samplesPerFrame;
+		info.sampleCount = samples > trimmed ? samples - trimmed : 0;
+		info.durationMs = info.sampleCount * 1000.0 / info.sampleRate;
+		info.averageBitrate = bitrate;
+		return true;
+	}
+
+	// Variable bitrate without header, or a damaged stream: every frame is read
+	MP3 mp3;
+	getMP3(mp3);
+	const MP3FrameIndex& index = mp3.getIndex();
+	info.source = MP3StreamInfo::FrameIndex;
+	info.frameCount = index.getFrameCount();
+	uint64_t samples = index.getTotalSamples();
+	if(hasVBRHeader == true && info.frameCount > 0){
+		info.frameCount--;
+		samples -= index.getSampleOffset(1);
+	}
+	info.sampleCount = samples > trimmed ? samples - trimmed : 0;
+	info.durationMs = info.sampleCount * 1000.0 / info.sampleRate;
+	uint64_t bytes = index.getTotalSize() - (hasVBRHeader == true ? headerFrameSize : 0);
+	info.averageBitrate = info.durationMs > 0 ? static_cast<uint32_t>(bytes * 8 / info.durationMs + 0.5) : 0;
+	return true;
+}
+
+bool MP3File::getAudioRange(uint64_t& start, uint64_t& end) const{
+	start = 0;
+	end = 0;
+	if(isEmpty() == true || tagsOnly == true){
+		return false;
+	}
+
+	const TagProbe& probe = getTagProbe();
+	start = probe.id3v2Size;
+	end = probe.appendedSize > 0 ? probe.appendedOffset : probe.id3v1Offset;
+	return true;
+}
+
+void MP3File::readID3v1Fields(const uint8_t* tail, const std::vector<std::string>& identifiers, std::map<std::string, std::string>& fields){
+	ID3 id3;
+	bool isID3v11 = tail[125] == 0 && tail[126] != 0;
+	if(isID3v11 == true){
+		id3.v1.v11 = new ID3v11();
+		std::memcpy(&id3.v1.v11->data, tail, sizeof(ID3v10Data));
+	}else{
+		id3.v1.v10 = new ID3v10();
+		std::memcpy(&id3.v1.v10->data, tail, sizeof(ID3v10Data));
+	}
+
+	for(const std::string& identifier : identifiers){
+		std::string value;
+		if(fields.count(identifier) == 0 && readID3v1Field(id3.v1, isID3v11, identifier, value) == true){
+			fields[identifier] = value;
+		}
+	}
+}
+
+const uint8_t* MP3File::getID3v2Bytes(uint64_t& tagSize) const{
+	tagSize = 0;
+	if(isEmpty() == true){
+		return nullptr;
+	}
+
+	const TagProbe& probe = getTagProbe();
+	if(probe.hasID3v2() == false){
+		return nullptr;
+	}
+
+	// ID3v2.4 unsynchronizes frame by frame, keeping the frame headers readable, so only older versions need a copy
+	bool isUnsynchronized = (data[5] & 0x80) != 0 && probe.has(TagProbe::ID3v24) == false;
+	if(isUnsynchronized == false){
+		tagSize = probe.id3v2Size;
+		return data;
+	}
+
+	if(resynchronized.empty() == true){
+		resynchronizeID3v2(data, probe.id3v2Size, resynchronized);
+	}
+
+	tagSize = resynchronized.size();
+	return resynchronized.data();
+}
+
+std::vector<uint8_t> MP3File::renderID3v2(const ID3v2& v2, uint64_t available) const{
+	uint8_t version = v2.getVersion();
+	if(version == 0){
+		return std::vector<uint8_t>();
+	}
+
+	uint64_t needed = 10 + static_cast<uint64_t>(version == 2 ? v2.v20->getFramesSize() : v2.v23->getFramesSize());
+
+	// An ID3v2.4 footer takes the place of the padding when it fits exactly
+	bool hasFooter = version == 4 && v2.v24->header.hasFooter() == true;
+
+	uint64_t padding = 0;
+	if(hasFooter == true && available == needed + 10){
+		padding = 0;
+	}else if(available >= needed){
+		padding = available - needed;
+	}else{
+		padding = paddingMinimum;
+		if(paddingAlignment > 0){
+			uint64_t remainder = (needed + padding) % paddingAlignment;
+			if(remainder > 0){
+				padding += paddingAlignment - remainder;
+			}
+		}
+	}
+
+	if(version == 2){
+		return v2.v20->toBytes(static_cast<uint32_t>(padding));
+	}else{
+		return v2.v23->toBytes(static_cast<uint32_t>(padding));
 	}
 }
 
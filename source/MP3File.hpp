@@ -11,6 +11,14 @@
 
 #include "File.hpp"
 #include "ID3.hpp"
+#include "ID3v2FrameView.hpp"
+#include "MP3.hpp"
+#include "MP3StreamInfo.hpp"
+#include "TagProbe.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
 
 /**
  * @brief MP3 file class that holds loaded ID3 tags and/or mp3 data.
@@ -27,6 +35,120 @@ class MP3File : public File{
 		 */
 		virtual ~MP3File();
 
+		/**
+		 * @brief Release all data and forget whether only the tags were loaded.
+		 */
+		void clear() override;
+
+		/**
+		 * @brief Load only the bytes that hold ID3 tags, never reading the audio payload.
+		 *
+		 * Reads the 10 byte ID3v2 header, the ID3v2 tag body (and v2.4 footer) it announces and the
+		 * last bytes of the file that may hold an ID3v1 tag. File::data then holds the head of the file
+		 * followed by its tail, so all hasID3vXX() functions and getID3() work as after File::load().
+		 *
+		 * @param file The file path to load the tags from.
+		 *
+		 * @return true if successful, false otherwise.
+		 *
+		 * @note A file loaded this way can not be changed by setID3() nor saved.
+		 */
+		bool loadTags(const char* file);
+
+		/**
+		 * @brief Read only the given frames of a file, without loading it.
+		 *
+		 * The first bytes of the file are read and the ID3v2 frames walked until all requested frames are found,
+		 * reading the rest of the ID3v2 tag only if a frame goes past them. The ID3v1 tag at the end of the file is
+		 * only read when the ID3v2 tag does not have all of them, for the frames that have an ID3v1 field.
+		 *
+		 * @param file The file path to read from.
+		 * @param identifiers Frame identifiers like "TIT2", "TPE1" or "TALB", matched to "TT2", "TP1" or "TAL" in an ID3v2.0 tag, the year "TYER" to "TDRC" in an ID3v2.4 tag.
+		 * @param fields Set to the payload of the first frame of each identifier found, keyed by the requested identifier.
+		 *
+		 * @return true if the file could be read, false otherwise.
+		 *
+		 * @note Payloads are returned as stored, like ID3v23::getTitle(), only the version 2.4 frame encoding is undone.
+		 */
+		static bool readFields(const char* file, const std::vector<std::string>& identifiers, std::map<std::string, std::string>& fields);
+
+		/**
+		 * @brief Check if a file name has the ".mp3" extension, in any case.
+		 *
+		 * @param filename The file name or path.
+		 *
+		 * @return true if it ends with ".mp3", false otherwise.
+		 */
+		static bool isMP3File(const std::string& filename);
+
+		/**
+		 * @brief Read the given frames of the loaded data, like readFields() does for a file.
+		 *
+		 * @param identifiers Frame identifiers like "TIT2", "TPE1" or "TALB", matched to "TT2", "TP1" or "TAL" in an ID3v2.0 tag, the year "TYER" to "TDRC" in an ID3v2.4 tag.
+		 * @param fields Set to the payload of the first frame of each identifier found, completed from the ID3v1 tag.
+		 */
+		void getFields(const std::vector<std::string>& identifiers, std::map<std::string, std::string>& fields) const;
+
+		/**
+		 * @brief Check if the data was loaded by loadTags().
+		 *
+		 * @return true if only the tags are loaded, false otherwise.
+		 */
+		bool isTagsOnly() const;
+
+		/**
+		 * @brief Get the size of the file on disk, even if only the tags were loaded.
+		 *
+		 * @return The file size in bytes.
+		 */
+		uint64_t getFileSize() const;
+
+		/**
+		 * @brief Write data into the given file.
+		 *
+		 * @param file The file path to save data to.
+		 *
+		 * @return true if successful, false otherwise or if only the tags were loaded.
+		 */
+		bool save(const char* file);
+
+		/**
+		 * @brief Write the loaded file without its ID3v1 and/or ID3v2 tag, leaving the loaded data unchanged.
+		 *
+		 * The same loaded (or mapped) data can be written several times, stripped of different tags, so a file
+		 * that feeds several outputs is read once.
+		 *
+		 * @param file The file path to write to.
+		 * @param removeID3v1 true to leave out the ID3v1 tag at the end.
+		 * @param removeID3v2 true to leave out the ID3v2 tag at the beginning.
+		 *
+		 * @return true if successful, false otherwise or if only the tags were loaded.
+		 */
+		bool saveWithoutTags(const char* file, bool removeID3v1, bool removeID3v2) const;
+
+		/**
+		 * @brief Write the given file without its ID3v1 and/or ID3v2 tag, copying the kept range from file to file.
+		 *
+		 * Only the tags need to be loaded, see loadTags(). The range is copied by the kernel (reflink, copy_file_range
+		 * or sendfile) when it can, so the audio never goes through this process. Removing only the ID3v1 tag of the
+		 * file itself is a truncate.
+		 *
+		 * @param file The loaded file path to read from.
+		 * @param output The file path to write to, file to edit it in place.
+		 * @param removeID3v1 true to leave out the ID3v1 tag at the end.
+		 * @param removeID3v2 true to leave out the ID3v2 tag at the beginning.
+		 *
+		 * @return true if successful, false otherwise.
+		 */
+		bool saveWithoutTags(const char* file, const char* output, bool removeID3v1, bool removeID3v2) const;
+
+		/**
+		 * @brief Locate all ID3 tags of the loaded data in one pass over its head and tail.
+		 *
+		 * @return The probe result, computed on first use and cached until the data changes.
+		 */
+		const TagProbe& getTagProbe() const;
+
 		/**
 		 * @brief Check if loaded data contains ID3 tag version 1.0.
 		 *
@@ -65,6 +187,9 @@ class MP3File : public File{
 		/**
 		 * @brief Get ID3 Tags if they exist.
 		 *
+		 * All frames of the ID3v2 tag are copied, resynchronized when the whole ID3v2.0 or ID3v2.3 tag is unsynchronized.
+		 * The ID3v2.3 extended header and the ID3v2.4 footer are read, the ID3v2.4 extended header is skipped.
+		 *
 		 * @return Copy of ID3 tag version 1 and/or version 2.
 		 */
 		ID3 getID3() const;
@@ -80,6 +205,168 @@ class MP3File : public File{
 		 * @brief Remove all ID3 tags.
 		 */
 		void removeTags();
+
+		/**
+		 * @brief Write the given ID3 tags into the loaded file on disk, touching only the tag bytes when possible.
+		 *
+		 * The ID3v2 tag is overwritten in place when it fits in the bytes of the current ID3v2 tag (frames and padding),
+		 * the rest being filled with padding. The ID3v1 tag is overwritten, appended or truncated in place.
+		 * Tag bytes equal to the ones on disk are not written, so removing only the ID3v1 tag is a single truncate.
+		 * When the ID3v2 tag grows, is added or is removed, or when output is another file, the new tags are written
+		 * to a temporary file, the audio is spliced behind them by the kernel (reflink, copy_file_range or sendfile,
+		 * with a buffered copy as last resort) and the temporary file is renamed over the output, synced to disk
+		 * first when it replaces file itself so a crash leaves either the old or the new file.
+		 *
+		 * @param file The file path the data was loaded from, by File::load() or loadTags().
+		 * @param id3 The ID3 tags to write.
+		 * @param output The file path to write to, nullptr to write into file itself.
+		 *
+		 * @return true if successful, false otherwise.
+		 *
+		 * @note When file itself is written the loaded data is released afterwards, load the file again to read it.
+		 *       Written to another file, the loaded data is kept, so several outputs can be saved from one load.
+		 */
+		bool saveID3(const char* file, const ID3& id3, const char* output = nullptr);
+
+		/**
+		 * @brief Set whether getID3() reads only the frame headers and leaves the payloads to be decoded on first use.
+		 *
+		 * In lazy mode getID3() makes one copy of the ID3v2 tag shared by all its frames, and each payload is copied,
+		 * resynchronized and stripped of its data length indicator only when ID3v23Frame::getData() or
+		 * ID3v20Frame::getData() is called, by the getters for instance. Frames never read are saved as stored.
+		 *
+		 * @param lazy true for lazy frames, false to decode all payloads in getID3(), the default.
+		 *
+		 * @note ID3v23Frame::data and ID3v20Frame::data are nullptr until decoded in lazy mode.
+		 */
+		void setLazyFrames(bool lazy);
+
+		/**
+		 * @brief Set how much padding is added when an ID3v2 tag has to be written with a new size.
+		 *
+		 * @param minimum Minimum number of padding bytes after the frames.
+		 * @param alignment The whole tag size, header included, is rounded up to a multiple of it. 0 disables rounding.
+		 *
+		 * @note With alignment 0, saveID3() on Linux also pads a grown tag so the audio keeps its offset modulo the file
+		 *       system block size, which FICLONERANGE needs to share the audio blocks instead of copying them. This
+		 *       adds less than one block.
+		 */
+		void setPaddingPolicy(uint32_t minimum, uint32_t alignment);
+
+		/**
+		 * @brief Get the size of the ID3v2 tag at the beginning of the loaded data.
+		 *
+		 * @return The size in bytes of header, frames, padding and footer, or 0 if there is no ID3v2 tag.
+		 */
+		uint64_t getID3v2Size() const;
+
+		/**
+		 * @brief Get the 128 bytes of the ID3v1 tag at the end of the loaded data, without copying them.
+		 *
+		 * @return Pointer to the tag, nullptr if there is no ID3v1 tag.
+		 *
+		 * @note The pointer is valid as long as the views of getFrameViews().
+		 */
+		const uint8_t* getID3v1Bytes() const;
+
+		/**
+		 * @brief Get views of all frames of the ID3v2 tag at the beginning of the loaded data, without copying them.
+		 *
+		 * @return The frames in tag order, empty if there is no ID3v2 tag.
+		 *
+		 * @note The views point into the loaded data, or into a resynchronized copy when the whole ID3v2.0 or ID3v2.3 tag
+		 *       is unsynchronized, and are valid until the data is changed, released or loaded again.
+		 */
+		std::vector<ID3v2FrameView> getFrameViews() const;
+
+		/**
+		 * @brief Get a view of the first frame with the given identifier, stopping the walk at it.
+		 *
+		 * @param identifier 3 characters for ID3v2.0, 4 characters for ID3v2.3 and ID3v2.4.
+		 * @param view Set to the frame when found.
+		 *
+		 * @return true if found, false otherwise.
+		 *
+		 * @note The view is valid as long as the ones of getFrameViews().
+		 */
+		bool getFrameView(const char* identifier, ID3v2FrameView& view) const;
+
+		/**
+		 * @brief Index the audio frames of the loaded data into an MP3, without copying them.
+		 *
+		 * The frames are read with MP3FrameReader between the ID3v2 tag (footer included) at the beginning and the
+		 * appended ID3v2.4 tag or ID3v1 tag at the end, skipping bytes that are not part of a frame.
+		 *
+		 * @param mp3 Cleared and set to the frames found, indexed by their offset in the loaded data (the file offset).
+		 *
+		 * @return true if the audio was read, false if nothing is loaded or only the tags were loaded.
+		 *
+		 * @note The index is valid until the data is changed, released or loaded again.
+		 */
+		bool getMP3(MP3& mp3) const;
+
+		/**
+		 * @brief Get the duration and average bitrate of the audio, reading as few frames as possible.
+		 *
+		 * The frame count of a Xing/Info or VBRI header in the first frame gives the duration at once, less the
+		 * encoder delay and padding of a LAME extension. Without one, when the first frames share the same bitrate
+		 * the audio size at that bitrate is used. Only a variable bitrate stream without header is fully indexed
+		 * with getMP3().
+		 *
+		 * @param info Reset and set to what was found, MP3StreamInfo::source telling how.
+		 *
+		 * @return true if the audio was read, false if nothing is loaded or only the tags were loaded.
+		 */
+		bool getStreamInfo(MP3StreamInfo& info) const;
+
+	private:
+		/**
+		 * @brief Get the range of the loaded data between the tags, where the audio frames are.
+		 *
+		 * @param start Set to the offset after the ID3v2 tag (footer included) at the beginning.
+		 * @param end Set to the offset of the appended ID3v2.4 tag or ID3v1 tag at the end, or of the end of the data.
+		 *
+		 * @return true if the whole file is loaded, false if nothing is loaded or only the tags were loaded.
+		 */
+		bool getAudioRange(uint64_t& start, uint64_t& end) const;
+
+		/**
+		 * @brief Serialize the given ID3v2 tag.
+		 *
+		 * @param v2 The tag to serialize.
+		 * @param available When the tag fits in this many bytes it is padded to exactly this size, otherwise the padding policy applies.
+		 *
+		 * @return The bytes of the whole tag, empty if v2 holds no tag.
+		 */
+		std::vector<uint8_t> renderID3v2(const ID3v2& v2, uint64_t available) const;
+
+		/**
+		 * @brief Get the bytes of the ID3v2 tag at the beginning of the loaded data, resynchronized if needed.
+		 *
+		 * @param tagSize Set to the number of bytes available from the returned pointer.
+		 *
+		 * @return Pointer to the tag, nullptr if there is no ID3v2 tag.
+		 */
+		const uint8_t* getID3v2Bytes(uint64_t& tagSize) const;
+
+		/**
+		 * @brief Set the fields not set yet from an ID3v1 tag, for readFields() and getFields().
+		 *
+		 * @param tail The 128 bytes of the ID3v1 tag.
+		 * @param identifiers Frame identifiers like "TIT2", matched to their ID3v1 field.
+		 * @param fields The fields to complete.
+		 */
+		static void readID3v1Fields(const uint8_t* tail, const std::vector<std::string>& identifiers, std::map<std::string, std::string>& fields);
+
+	private:
+		bool tagsOnly;		///< Whether File::data holds only the head and tail of the file, see loadTags().
+		uint64_t fileSize;	///< Size of the file on disk when tagsOnly is set.
+		uint32_t paddingMinimum;	///< Minimum padding bytes of a resized ID3v2 tag, see setPaddingPolicy().
+		uint32_t paddingAlignment;	///< Alignment of the size of a resized ID3v2 tag, see setPaddingPolicy().
+		mutable TagProbe tagProbe;	///< Cached result of getTagProbe().
+		mutable bool probed;		///< Whether tagProbe matches the loaded data.
+		mutable std::vector<uint8_t> resynchronized;	///< Resynchronized copy of an unsynchronized ID3v2 tag, see getID3v2Bytes().
+		bool lazyFrames;	///< Whether getID3() leaves frame payloads to be decoded on first use, see setLazyFrames().
 };
 
 #endif /* EMP3FILE_HPP */
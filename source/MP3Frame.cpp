@@ -2,17 +2,118 @@
 
 #include <cstring>
 
-MP3Frame::MP3Frame() : header(), audioData() {
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+	#define MP3FRAME_SSE2
+	#include <emmintrin.h>
+#if defined(__GNUC__)
+		#define MP3FRAME_AVX2
+		#include <immintrin.h>
+#endif
+#endif
+
+/**
+ * @brief Signature of the sync word searches, returning the offset of the first 0xFF 0xEx pair from from, or size.
+ */
+typedef uint64_t (*FindSyncFunction)(const uint8_t* data, uint64_t from, uint64_t size);
+
+/**
+ * @brief Search one byte at a time, for the last bytes and CPUs without SSE2.
+ */
+static uint64_t findSyncScalar(const uint8_t* data, uint64_t from, uint64_t size) {
+	for (uint64_t i = from; i + 1 < size; i++) {
+		if (data[i] == 0xFF && (data[i + 1] & 0xE0) == 0xE0) {
+			return i;
+		}
+	}
+	return size;
+}
+
+#ifdef MP3FRAME_SSE2
+/**
+ * @brief Search 16 positions at a time: bytes equal to 0xFF whose next byte has the 3 high bits set.
+ */
+static uint64_t findSyncSSE2(const uint8_t* data, uint64_t from, uint64_t size) {
+	const __m128i ff = _mm_set1_epi8(static_cast<char>(0xFF));
+	const __m128i e0 = _mm_set1_epi8(static_cast<char>(0xE0));
+
+	uint64_t i = from;
+	for (; i + 17 <= size; i += 16) {
+		__m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[i]));
+		__m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[i + 1]));
+		__m128i sync = _mm_and_si128(_mm_cmpeq_epi8(first, ff), _mm_cmpeq_epi8(_mm_and_si128(second, e0), e0));
+		int mask = _mm_movemask_epi8(sync);
+		if (mask != 0) {
+#if defined(__GNUC__)
+			return i + __builtin_ctz(static_cast<unsigned int>(mask));
+#else
+			unsigned long bit;
+			_BitScanForward(&bit, static_cast<unsigned long>(mask));
+			return i + bit;
+#endif
+		}
+	}
+	return findSyncScalar(data, i, size);
+}
+#endif
+
+#ifdef MP3FRAME_AVX2
+/**
+ * @brief Search 32 positions at a time, like findSyncSSE2().
+ */
+__attribute__((target("avx2")))
+static uint64_t findSyncAVX2(const uint8_t* data, uint64_t from, uint64_t size) {
+	const __m256i ff = _mm256_set1_epi8(static_cast<char>(0xFF));
+	const __m256i e0 = _mm256_set1_epi8(static_cast<char>(0xE0));
+
+	uint64_t i = from;
+	for (; i + 33 <= size; i += 32) {
+		__m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&data[i]));
+		__m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&data[i + 1]));
+		__m256i sync = _mm256_and_si256(_mm256_cmpeq_epi8(first, ff), _mm256_cmpeq_epi8(_mm256_and_si256(second, e0), e0));
+		unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(sync));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return findSyncSSE2(data, i, size);
+}
+#endif
+
+/**
+ * @brief Pick the widest search the CPU runs, once.
+ */
+static FindSyncFunction selectFindSync() {
+#if defined(MP3FRAME_AVX2)
+	if (__builtin_cpu_supports("avx2")) {
+		return findSyncAVX2;
+	}
+#endif
+#if defined(MP3FRAME_SSE2)
+	return findSyncSSE2;
+#else
+	return findSyncScalar;
+#endif
+}
+
+MP3Frame::MP3Frame() : header(), audioData(), view(nullptr), viewSize(0) {
 }
 
 MP3Frame::MP3Frame(const MP3FrameHeader& header, const uint8_t* frameData, uint16_t dataSize)
-	: header(header), audioData() {
+	: header(header), audioData(), view(nullptr), viewSize(0) {
 	if (frameData != nullptr && dataSize > 0) {
 		audioData.resize(dataSize);
 		std::memcpy(audioData.data(), frameData, dataSize);
 	}
 }
 
+MP3Frame::MP3Frame(const uint8_t* frame, uint16_t frameSize)
+	: header(frame), audioData(), view(nullptr), viewSize(0) {
+	if (frame != nullptr && frameSize > 4) {
+		view = frame + 4;
+		viewSize = frameSize - 4;
+	}
+}
+
 MP3Frame::~MP3Frame() {
 	audioData.clear();
 }
@@ -30,14 +131,25 @@ void MP3Frame::setHeader(const MP3FrameHeader& newHeader) {
 }
 
 uint8_t* MP3Frame::getData() {
+	// The data may be changed through the pointer, so a view gets its own copy first
+	if (view != nullptr) {
+		audioData.assign(view, view + viewSize);
+		view = nullptr;
+		viewSize = 0;
+	}
 	return audioData.empty() ? nullptr : audioData.data();
 }
 
 const uint8_t* MP3Frame::getData() const {
+	if (view != nullptr) {
+		return view;
+	}
 	return audioData.empty() ? nullptr : audioData.data();
 }
 
 void MP3Frame::setData(const uint8_t* data, uint16_t size) {
+	view = nullptr;
+	viewSize = 0;
 	audioData.clear();
 	if (data != nullptr && size > 0) {
 		audioData.resize(size);
@@ -46,6 +158,9 @@ void MP3Frame::setData(const uint8_t* data, uint16_t size) {
 }
 
 uint16_t MP3Frame::getDataSize() const {
+	if (view != nullptr) {
+		return viewSize;
+	}
 	return static_cast<uint16_t>(audioData.size());
 }
 
@@ -71,6 +186,75 @@ double MP3Frame::getFrameDurationMs() const {
 		return 0.0;
 	}
 
-	double durationMs = (1152.0 / sampleRate) * 1000.0;
+	double durationMs = (static_cast<double>(header.getSamplesPerFrame()) / sampleRate) * 1000.0;
 	return durationMs;
 }
+
+MP3FrameReader::MP3FrameReader(const uint8_t* audio, uint64_t size)
+	: audio(audio), size(audio != nullptr ? size : 0), position(0), lastOffset(0), skipped(0), resyncs(0), inSync(false) {
+}
+
+MP3FrameReader::~MP3FrameReader() {
+}
+
+bool MP3FrameReader::next(uint64_t& offset, MP3FrameHeader& header) {
+	while (position + 4 <= size) {
+		uint16_t frameSize = getFrameSizeAt(position);
+		if (frameSize > 0) {
+			// In sync a frame must continue the stream of the previous one, out of sync the next one must continue it
+			uint64_t nextPosition = position + frameSize;
+			bool confirmed = inSync ? isSameStream(&audio[lastOffset], &audio[position]) :
+				nextPosition == size || (getFrameSizeAt(nextPosition) > 0 && isSameStream(&audio[position], &audio[nextPosition]));
+			if (confirmed) {
+				offset = position;
+				header = MP3FrameHeader(&audio[position]);
+				lastOffset = position;
+				position = nextPosition;
+				inSync = true;
+				return true;
+			}
+		}
+
+		if (inSync) {
+			inSync = false;
+			resyncs++;
+		}
+		uint64_t syncPosition = findSync(position + 1);
+		skipped += syncPosition - position;
+		position = syncPosition;
+	}
+
+	skipped += size - position;
+	position = size;
+	return false;
+}
+
+uint64_t MP3FrameReader::getSkippedBytes() const {
+	return skipped;
+}
+
+uint32_t MP3FrameReader::getResyncCount() const {
+	return resyncs;
+}
+
+uint16_t MP3FrameReader::getFrameSizeAt(uint64_t offset) const {
+	if (offset + 4 > size || audio[offset] != 0xFF) {
+		return 0;
+	}
+	MP3FrameHeader header(&audio[offset]);
+	if (!header.isValidSync()) {
+		return 0;
+	}
+	uint16_t frameSize = header.getFrameSize();
+	return (frameSize > 4 && offset + frameSize <= size) ? frameSize : 0;
+}
+
+bool MP3FrameReader::isSameStream(const uint8_t* first, const uint8_t* second) {
+	// Version and layer are in byte 1 (the CRC bit may change), the sample rate in byte 2
+	return (first[1] & 0xFE) == (second[1] & 0xFE) && (first[2] & 0x0C) == (second[2] & 0x0C);
+}
+
+uint64_t MP3FrameReader::findSync(uint64_t from) const {
+	static const FindSyncFunction findSyncFunction = selectFindSync();
+	return findSyncFunction(audio, from, size);
+}
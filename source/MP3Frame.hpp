@@ -39,6 +39,16 @@ class MP3Frame {
 		 */
 		MP3Frame(const MP3FrameHeader& header, const uint8_t* frameData, uint16_t dataSize);
 
+		/**
+		 * @brief Constructor that views a frame in place, header included, without copying its data.
+		 *
+		 * @param frame Pointer to the frame header followed by its data, valid as long as the frame is used.
+		 * @param frameSize Size of the frame in bytes, header included.
+		 *
+		 * @note The data is copied into the frame only when changed through getData() or setData().
+		 */
+		MP3Frame(const uint8_t* frame, uint16_t frameSize);
+
 		/**
 		 * @brief Virtual destructor.
 		 */
@@ -66,7 +76,7 @@ class MP3Frame {
 		void setHeader(const MP3FrameHeader& header);
 
 		/**
-		 * @brief Get frame data.
+		 * @brief Get frame data, copying it first if the frame is a view.
 		 *
 		 * @return Pointer to frame data bytes.
 		 */
@@ -111,7 +121,7 @@ class MP3Frame {
 		/**
 		 * @brief Get frame duration in milliseconds.
 		 *
-		 * @return Duration in milliseconds (typically ~26ms for 1152 samples at 44.1kHz).
+		 * @return Duration in milliseconds (typically ~26ms for 1152 samples at 44.1kHz), see MP3FrameHeader::getSamplesPerFrame().
 		 */
 		double getFrameDurationMs() const;
 
@@ -129,6 +139,101 @@ class MP3Frame {
 		 * @brief Frame audio data.
 		 */
 		std::vector<uint8_t> audioData;
+
+		/**
+		 * @var const uint8_t* MP3Frame::view
+		 *
+		 * @brief Frame data viewed in place, nullptr once copied into audioData or if the frame owns its data.
+		 */
+		const uint8_t* view;
+
+		/**
+		 * @var uint16_t MP3Frame::viewSize
+		 *
+		 * @brief Size of the data viewed in place.
+		 */
+		uint16_t viewSize;
+};
+
+/**
+ * @class MP3FrameReader
+ *
+ * @brief Walks the audio frames of a buffer in place, one frame header at a time.
+ *
+ * A header is accepted when its sync word is valid (MP3FrameHeader::isValidSync()), it has a frame size
+ * (MP3FrameHeader::getFrameSize()) and the frame fits in the buffer. Until the reader is in sync, at the
+ * start and after garbage, a frame is only taken when the next header has the same MPEG version, layer
+ * and sample rate, or the frame ends the buffer, so sync-like bytes in junk or tag padding are skipped.
+ * Bytes that are not part of a frame are skipped by searching for the next sync word, see findSync().
+ */
+class MP3FrameReader {
+	public:
+		/**
+		 * @brief Constructor over the audio bytes, without the ID3 tags.
+		 *
+		 * @param audio Pointer to the first byte that may hold a frame.
+		 * @param size Number of bytes available from audio.
+		 */
+		MP3FrameReader(const uint8_t* audio, uint64_t size);
+
+		/**
+		 * @brief Virtual destructor.
+		 */
+		virtual ~MP3FrameReader();
+
+		/**
+		 * @brief Read the next frame.
+		 *
+		 * @param offset Set to the offset of the frame header from audio.
+		 * @param header Set to the frame header.
+		 *
+		 * @return true if a frame was found, false at the end of the buffer.
+		 */
+		bool next(uint64_t& offset, MP3FrameHeader& header);
+
+		/**
+		 * @brief Get the number of bytes skipped because they were not part of a frame.
+		 *
+		 * @return Bytes skipped so far.
+		 */
+		uint64_t getSkippedBytes() const;
+
+		/**
+		 * @brief Get the number of times the reader lost sync and had to search for a frame again.
+		 *
+		 * @return Number of resyncs so far.
+		 */
+		uint32_t getResyncCount() const;
+
+	private:
+		/**
+		 * @brief Get the size of the frame at the given offset.
+		 *
+		 * @return Frame size in bytes, or 0 if no valid frame that fits in the buffer starts there.
+		 */
+		uint16_t getFrameSizeAt(uint64_t offset) const;
+
+		/**
+		 * @brief Check if two headers have the same MPEG version, layer and sample rate.
+		 */
+		static bool isSameStream(const uint8_t* first, const uint8_t* second);
+
+		/**
+		 * @brief Find the next byte pair that starts with a sync word.
+		 *
+		 * Compares 32 bytes at a time with AVX2 or 16 with SSE2, picked at run time, one at a time on other CPUs.
+		 *
+		 * @return The offset of the pair, or the buffer size if there is none.
+		 */
+		uint64_t findSync(uint64_t from) const;
+
+		const uint8_t* audio;	///< Pointer to the first byte that may hold a frame.
+		uint64_t size;			///< Number of bytes available from audio.
+		uint64_t position;		///< Offset of the next byte to read.
+		uint64_t lastOffset;	///< Offset of the last frame read.
+		uint64_t skipped;		///< Bytes skipped, see getSkippedBytes().
+		uint32_t resyncs;		///< Times sync was lost, see getResyncCount().
+		bool inSync;			///< Whether the last byte read ended a frame.
 };
 
 #endif /* MP3FRAME_HPP */
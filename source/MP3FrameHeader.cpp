@@ -2,32 +2,86 @@
 
 #include <cstring>
 
-static const uint16_t BITRATE_TABLE[4][3][16] = {
-	{
-		{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
-	},
-	{
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
-	},
-	{
-		{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
-	},
-	{
-		{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
-		{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
-		{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0}
-	}
+/**
+ * @brief Bitrates in kbps by bitrate index, for MPEG-1 Layer I, II and III and MPEG-2/2.5 Layer I and Layer II/III.
+ */
+static constexpr uint16_t BITRATE_ROWS[5][16] = {
+	{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0},
+	{0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},
+	{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
+	{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},
+	{0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}
 };
 
-static const uint32_t SAMPLE_RATE_TABLE[4][4] = {
+/**
+ * @brief Sample rates in Hz by MPEG version bits and sample rate index, 0 for reserved values.
+ */
+static constexpr uint32_t SAMPLE_RATE_TABLE[4][4] = {
 	{11025, 12000, 8000, 0},
 	{0, 0, 0, 0},
 	{22050, 24000, 16000, 0},
 	{44100, 48000, 32000, 0}
 };
 
+/**
+ * @brief Header decoding tables, indexed by header bits so each value is one load.
+ *
+ * The version and layer bits (byte 1, bits 4-1) select the row; bitrates are indexed by byte 2 bits 7-4 and frame
+ * sizes by byte 2 bits 7-1 (bitrate, sample rate and padding). Reserved and free format values give 0.
+ */
+struct MP3FrameHeaderTables {
+	uint16_t bitrate[16][16];		///< Bitrate in kbps.
+	uint16_t samplesPerFrame[16];	///< Samples per channel of a frame.
+	uint16_t frameSize[16][128];	///< Frame size in bytes, header included.
+};
+
+/**
+ * @brief Fill the tables from the bitrate rows and the frame size formulas.
+ */
+static constexpr MP3FrameHeaderTables makeTables() {
+	MP3FrameHeaderTables tables{};
+	for (uint32_t versionLayer = 0; versionLayer < 16; versionLayer++) {
+		uint32_t version = versionLayer >> 2;
+		uint32_t layer = versionLayer & 0x03;
+		if (version == MP3FrameHeader::Reserved || layer == MP3FrameHeader::LayerReserved) {
+			continue;
+		}
+
+		bool isMPEG1 = version == MP3FrameHeader::MPEG1;
+		uint32_t row = isMPEG1 ? (layer == MP3FrameHeader::LayerI ? 0 : layer == MP3FrameHeader::LayerII ? 1 : 2) :
+			(layer == MP3FrameHeader::LayerI ? 3 : 4);
+		tables.samplesPerFrame[versionLayer] = layer == MP3FrameHeader::LayerI ? 384 :
+			(layer == MP3FrameHeader::LayerIII && !isMPEG1) ? 576 : 1152;
+
+		for (uint32_t bits = 0; bits < 128; bits++) {
+			uint32_t bitrate = BITRATE_ROWS[row][bits >> 3];
+			uint32_t sampleRate = SAMPLE_RATE_TABLE[version][(bits >> 1) & 0x03];
+			uint32_t padding = bits & 0x01;
+			tables.bitrate[versionLayer][bits >> 3] = static_cast<uint16_t>(bitrate);
+			if (bitrate == 0 || sampleRate == 0) {
+				continue;
+			}
+
+			// Layer I counts 4-byte slots; samples / 8 bytes per bit otherwise, 144 or 72 for 1152 or 576 samples
+			if (layer == MP3FrameHeader::LayerI) {
+				tables.frameSize[versionLayer][bits] = static_cast<uint16_t>((12000 * bitrate / sampleRate + padding) * 4);
+			} else {
+				uint32_t slots = tables.samplesPerFrame[versionLayer] / 8;
+				tables.frameSize[versionLayer][bits] = static_cast<uint16_t>(slots * 1000 * bitrate / sampleRate + padding);
+			}
+		}
+	}
+	return tables;
+}
+
+/**
+ * @brief The header decoding tables, built at compile time.
+ */
+static constexpr MP3FrameHeaderTables TABLES = makeTables();
+
+static_assert(TABLES.frameSize[0x0D][0x48] == 417, "MPEG-1 Layer III 128 kbps 44.1 kHz frames are 417 bytes");
+static_assert(TABLES.frameSize[0x09][0x48] == 261, "MPEG-2 Layer III 80 kbps 22.05 kHz frames are 261 bytes, 576 samples");
+
 MP3FrameHeader::MP3FrameHeader() {
 	std::memset(&data, 0, sizeof(MP3FrameHeaderData));
 	data.data[0] = 0xFF;
@@ -36,6 +90,10 @@ MP3FrameHeader::MP3FrameHeader() {
 	data.data[3] = 0;
 }
 
+MP3FrameHeader::MP3FrameHeader(const uint8_t* raw) {
+	std::memcpy(data.data, raw, sizeof(data.data));
+}
+
 MP3FrameHeader::~MP3FrameHeader() {
 	std::memset(&data, 0, sizeof(MP3FrameHeaderData));
 }
@@ -84,19 +142,7 @@ void MP3FrameHeader::setBitrateIndex(BitrateIndex index) {
 }
 
 uint16_t MP3FrameHeader::getBitrate() const {
-	MPEGVersion version = getMPEGVersion();
-	Layer layer = getLayer();
-	BitrateIndex index = getBitrateIndex();
-
-	if (version == Reserved || layer == LayerReserved) {
-		return 0;
-	}
-
-	// Layer is stored as: 0=Reserved, 1=LayerIII, 2=LayerII, 3=LayerI
-	// Table is indexed as: 0=LayerI, 1=LayerII, 2=LayerIII
-	uint8_t layerIdx = (layer == LayerI) ? 0 : (layer == LayerII) ? 1 : 2;
-
-	return BITRATE_TABLE[version][layerIdx][index];
+	return TABLES.bitrate[(data.data[1] >> 1) & 0x0F][data.data[2] >> 4];
 }
 
 MP3FrameHeader::SampleRate MP3FrameHeader::getSampleRateIndex() const {
@@ -109,14 +155,7 @@ void MP3FrameHeader::setSampleRateIndex(SampleRate rate) {
 }
 
 uint32_t MP3FrameHeader::getSampleRate() const {
-	MPEGVersion version = getMPEGVersion();
-	SampleRate rateIdx = getSampleRateIndex();
-
-	if (version == Reserved || rateIdx == SR_Reserved) {
-		return 0;
-	}
-
-	return SAMPLE_RATE_TABLE[version][rateIdx];
+	return SAMPLE_RATE_TABLE[(data.data[1] >> 3) & 0x03][(data.data[2] >> 2) & 0x03];
 }
 
 bool MP3FrameHeader::hasPadding() const {
@@ -135,26 +174,11 @@ uint16_t MP3FrameHeader::getFrameSize() const {
 	if (!isValidSync()) {
 		return 0;
 	}
+	return TABLES.frameSize[(data.data[1] >> 1) & 0x0F][data.data[2] >> 1];
+}
 
-	uint32_t sampleRate = getSampleRate();
-	uint16_t bitrate = getBitrate();
-
-	if (sampleRate == 0 || bitrate == 0) {
-		return 0;
-	}
-
-	Layer layer = getLayer();
-	uint16_t frameSize = 0;
-
-	if (layer == LayerIII || layer == LayerII) {
-		// Frame size = (144 * bitrate / sampleRate) + padding
-		frameSize = (144000 * bitrate / sampleRate) + (hasPadding() ? 1 : 0);
-	} else if (layer == LayerI) {
-		// Frame size = (12 * bitrate / sampleRate + padding) * 4
-		frameSize = ((12000 * bitrate / sampleRate) + (hasPadding() ? 1 : 0)) * 4;
-	}
-
-	return frameSize;
+uint16_t MP3FrameHeader::getSamplesPerFrame() const {
+	return TABLES.samplesPerFrame[(data.data[1] >> 1) & 0x0F];
 }
 
 const uint8_t* MP3FrameHeader::getRawData() const {
@@ -104,6 +104,13 @@ class MP3FrameHeader {
 		 */
 		MP3FrameHeader();
 
+		/**
+		 * @brief Constructor that copies a header as stored in a file.
+		 *
+		 * @param raw Pointer to the 4 header bytes.
+		 */
+		explicit MP3FrameHeader(const uint8_t* raw);
+
 		/**
 		 * @brief Virtual destructor.
 		 */
@@ -175,7 +182,7 @@ class MP3FrameHeader {
 		/**
 		 * @brief Get bitrate in kbps based on MPEG version and layer.
 		 *
-		 * @return Bitrate in kbps, or 0 if invalid.
+		 * @return Bitrate in kbps, or 0 if invalid or free format.
 		 */
 		uint16_t getBitrate() const;
 
@@ -196,7 +203,7 @@ class MP3FrameHeader {
 		/**
 		 * @brief Get sample rate in Hz.
 		 *
-		 * @return Sample rate in Hz (44100, 48000, or 32000).
+		 * @return Sample rate in Hz (44100, 48000 or 32000 for MPEG-1, half for MPEG-2, a quarter for MPEG-2.5), or 0 if invalid.
 		 */
 		uint32_t getSampleRate() const;
 
@@ -217,10 +224,17 @@ class MP3FrameHeader {
 		/**
 		 * @brief Get frame size in bytes (header + data).
 		 *
-		 * @return Frame size in bytes, or 0 if invalid.
+		 * @return Frame size in bytes, or 0 if invalid or free format.
 		 */
 		uint16_t getFrameSize() const;
 
+		/**
+		 * @brief Get the number of audio samples per channel the frame decodes to.
+		 *
+		 * @return 384 for Layer I, 1152 for Layer II and MPEG-1 Layer III, 576 for MPEG-2/2.5 Layer III, or 0 if invalid.
+		 */
+		uint16_t getSamplesPerFrame() const;
+
 		/**
 		 * @brief Get the raw 4-byte header data.
 		 *
@@ -0,0 +1,118 @@
+#include "MP3FrameIndex.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+MP3FrameIndex::MP3FrameIndex() : buffer(nullptr), offsets(), headers(), sampleEnds(), totalSize(0) {
+}
+
+MP3FrameIndex::~MP3FrameIndex() {
+	clear();
+}
+
+void MP3FrameIndex::reset(const uint8_t* newBuffer) {
+	clear();
+	buffer = newBuffer;
+}
+
+void MP3FrameIndex::reserve(uint32_t count) {
+	offsets.reserve(count);
+	headers.reserve(count);
+	sampleEnds.reserve(count);
+}
+
+void MP3FrameIndex::addFrame(uint64_t offset) {
+	MP3FrameHeaderData header;
+	std::memcpy(header.data, &buffer[offset], sizeof(header.data));
+	MP3FrameHeader decoded(header.data);
+
+	offsets.push_back(offset);
+	headers.push_back(header);
+	sampleEnds.push_back(getTotalSamples() + decoded.getSamplesPerFrame());
+	totalSize += decoded.getFrameSize();
+}
+
+bool MP3FrameIndex::removeFrame(uint32_t index) {
+	if (index >= offsets.size()) {
+		return false;
+	}
+
+	MP3FrameHeader removed(headers[index].data);
+	uint16_t samples = removed.getSamplesPerFrame();
+	totalSize -= removed.getFrameSize();
+
+	offsets.erase(offsets.begin() + index);
+	headers.erase(headers.begin() + index);
+	sampleEnds.erase(sampleEnds.begin() + index);
+	for (std::size_t i = index; i < sampleEnds.size(); i++) {
+		sampleEnds[i] -= samples;
+	}
+	return true;
+}
+
+void MP3FrameIndex::clear() {
+	offsets.clear();
+	headers.clear();
+	sampleEnds.clear();
+	totalSize = 0;
+}
+
+bool MP3FrameIndex::isEmpty() const {
+	return offsets.empty();
+}
+
+uint32_t MP3FrameIndex::getFrameCount() const {
+	return static_cast<uint32_t>(offsets.size());
+}
+
+const uint8_t* MP3FrameIndex::getBuffer() const {
+	return buffer;
+}
+
+uint64_t MP3FrameIndex::getOffset(uint32_t index) const {
+	if (index >= offsets.size()) {
+		throw std::out_of_range("Frame index out of range");
+	}
+	return offsets[index];
+}
+
+MP3FrameHeader MP3FrameIndex::getHeader(uint32_t index) const {
+	if (index >= headers.size()) {
+		throw std::out_of_range("Frame index out of range");
+	}
+	return MP3FrameHeader(headers[index].data);
+}
+
+MP3Frame MP3FrameIndex::getFrame(uint32_t index) const {
+	if (index >= offsets.size()) {
+		throw std::out_of_range("Frame index out of range");
+	}
+	return MP3Frame(&buffer[offsets[index]], MP3FrameHeader(headers[index].data).getFrameSize());
+}
+
+uint64_t MP3FrameIndex::getSampleOffset(uint32_t index) const {
+	if (index > sampleEnds.size()) {
+		throw std::out_of_range("Frame index out of range");
+	}
+	return index == 0 ? 0 : sampleEnds[index - 1];
+}
+
+uint64_t MP3FrameIndex::getTotalSamples() const {
+	return sampleEnds.empty() ? 0 : sampleEnds.back();
+}
+
+uint32_t MP3FrameIndex::findFrame(uint64_t sample) const {
+	// The first frame that ends after the sample holds it
+	auto it = std::upper_bound(sampleEnds.begin(), sampleEnds.end(), sample);
+	return static_cast<uint32_t>(it - sampleEnds.begin());
+}
+
+uint64_t MP3FrameIndex::getTotalSize() const {
+	return totalSize;
+}
+
+std::size_t MP3FrameIndex::getMemoryUsage() const {
+	return offsets.capacity() * sizeof(uint64_t) + headers.capacity() * sizeof(MP3FrameHeaderData) +
+		sampleEnds.capacity() * sizeof(uint64_t);
+}
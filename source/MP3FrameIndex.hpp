@@ -0,0 +1,171 @@
+#ifndef MP3FRAMEINDEX_HPP
+#define MP3FRAMEINDEX_HPP
+
+/**
+ * @file MP3FrameIndex.hpp
+ *
+ * @author Evandro L. Vieira
+ *
+ * @brief This file contains the definition of the class MP3FrameIndex.
+ */
+
+#include "MP3Frame.hpp"
+#include "MP3FrameHeader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class MP3FrameIndex
+ *
+ * @brief Compact index of the audio frames of a buffer, kept as parallel arrays.
+ *
+ * Each frame takes 20 bytes: its offset in the buffer, its raw 4-byte header and the number of samples up to
+ * its end. The audio stays in the buffer, MP3Frame views of it are made on demand by getFrame().
+ *
+ * @note The buffer must outlive the index, and stay unchanged while the index is used.
+ */
+class MP3FrameIndex {
+	public:
+		/**
+		 * @brief Default constructor that initializes an empty index without buffer.
+		 */
+		MP3FrameIndex();
+
+		/**
+		 * @brief Virtual destructor.
+		 */
+		virtual ~MP3FrameIndex();
+
+		/**
+		 * @brief Clear the index and set the buffer the frame offsets refer to.
+		 *
+		 * @param buffer Pointer to the buffer, usually the whole loaded file.
+		 */
+		void reset(const uint8_t* buffer);
+
+		/**
+		 * @brief Reserve room for the given number of frames, so adding them does not reallocate.
+		 *
+		 * @param count Expected number of frames.
+		 */
+		void reserve(uint32_t count);
+
+		/**
+		 * @brief Add the frame at the given offset of the buffer, after the last one.
+		 *
+		 * @param offset Offset of the frame header in the buffer.
+		 */
+		void addFrame(uint64_t offset);
+
+		/**
+		 * @brief Remove a frame, the samples of the frames after it are counted again.
+		 *
+		 * @param index Frame index to remove (0-based).
+		 *
+		 * @return true if removed successfully, false if index invalid.
+		 */
+		bool removeFrame(uint32_t index);
+
+		/**
+		 * @brief Clear all frames, keeping the buffer.
+		 */
+		void clear();
+
+		/**
+		 * @brief Check if no frames exist.
+		 *
+		 * @return true if empty, false otherwise.
+		 */
+		bool isEmpty() const;
+
+		/**
+		 * @brief Get the number of frames.
+		 *
+		 * @return Number of MP3 frames.
+		 */
+		uint32_t getFrameCount() const;
+
+		/**
+		 * @brief Get the buffer the frame offsets refer to.
+		 *
+		 * @return Pointer to the buffer, or nullptr if none was set.
+		 */
+		const uint8_t* getBuffer() const;
+
+		/**
+		 * @brief Get the offset of a frame in the buffer.
+		 *
+		 * @param index Frame index (0-based).
+		 *
+		 * @return Offset of the frame header, or throws std::out_of_range if invalid.
+		 */
+		uint64_t getOffset(uint32_t index) const;
+
+		/**
+		 * @brief Get the header of a frame.
+		 *
+		 * @param index Frame index (0-based).
+		 *
+		 * @return Copy of the frame header, or throws std::out_of_range if invalid.
+		 */
+		MP3FrameHeader getHeader(uint32_t index) const;
+
+		/**
+		 * @brief Get a view of a frame, without copying its data.
+		 *
+		 * @param index Frame index (0-based).
+		 *
+		 * @return MP3Frame viewing the buffer, or throws std::out_of_range if invalid.
+		 */
+		MP3Frame getFrame(uint32_t index) const;
+
+		/**
+		 * @brief Get the number of samples before a frame.
+		 *
+		 * @param index Frame index (0-based), getFrameCount() for the total.
+		 *
+		 * @return Samples per channel of the frames before index, or throws std::out_of_range if invalid.
+		 */
+		uint64_t getSampleOffset(uint32_t index) const;
+
+		/**
+		 * @brief Get the number of samples of all frames.
+		 *
+		 * @return Samples per channel.
+		 */
+		uint64_t getTotalSamples() const;
+
+		/**
+		 * @brief Find the frame holding the given sample, for seeking.
+		 *
+		 * @param sample Sample per channel from the start of the audio.
+		 *
+		 * @return Index of the frame, getFrameCount() if the sample is past the last frame.
+		 */
+		uint32_t findFrame(uint64_t sample) const;
+
+		/**
+		 * @brief Get the total size of all frames (including headers).
+		 *
+		 * @return Total size in bytes.
+		 */
+		uint64_t getTotalSize() const;
+
+		/**
+		 * @brief Get the memory held by the arrays of the index.
+		 *
+		 * @return Size in bytes of the reserved arrays.
+		 */
+		std::size_t getMemoryUsage() const;
+
+	private:
+		const uint8_t* buffer;						///< Buffer the offsets refer to.
+		std::vector<uint64_t> offsets;				///< Offset of each frame header in the buffer.
+		std::vector<MP3FrameHeaderData> headers;	///< Raw header of each frame.
+		std::vector<uint64_t> sampleEnds;			///< Samples per channel up to the end of each frame.
+		uint64_t totalSize;							///< Sum of the frame sizes.
+};
+
+#endif /* MP3FRAMEINDEX_HPP */
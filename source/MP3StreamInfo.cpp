@@ -0,0 +1,205 @@
+#include "MP3StreamInfo.hpp"
+
+#include <cstring>
+
+/**
+ * @brief Xing header flag of the frame count field.
+ */
+static const uint32_t XING_FRAMES = 0x01;
+
+/**
+ * @brief Xing header flag of the byte count field.
+ */
+static const uint32_t XING_BYTES = 0x02;
+
+/**
+ * @brief Xing header flag of the 100-byte table of contents.
+ */
+static const uint32_t XING_TOC = 0x04;
+
+/**
+ * @brief Xing header flag of the quality field.
+ */
+static const uint32_t XING_QUALITY = 0x08;
+
+/**
+ * @brief Offset of the VBRI header from the frame start: the frame header and 32 bytes, whatever the stream.
+ */
+static const uint64_t VBRI_OFFSET = 4 + 32;
+
+/**
+ * @brief Read a big-endian number of the given size.
+ */
+static uint32_t readBigEndian(const uint8_t* in, std::size_t size) {
+	uint32_t value = 0;
+	for (std::size_t i = 0; i < size; i++) {
+		value = (value << 8) | in[i];
+	}
+	return value;
+}
+
+MP3VBRHeader::MP3VBRHeader()
+	: type(None), frameCount(0), byteCount(0), toc(), hasDelay(false), encoderDelay(0), encoderPadding(0) {
+}
+
+MP3VBRHeader::~MP3VBRHeader() {
+}
+
+bool MP3VBRHeader::parse(const uint8_t* frame, uint64_t size) {
+	type = None;
+	frameCount = 0;
+	byteCount = 0;
+	toc.clear();
+	hasDelay = false;
+	encoderDelay = 0;
+	encoderPadding = 0;
+
+	if (frame == nullptr || size < 4) {
+		return false;
+	}
+
+	// The Xing header follows the side information, whose size depends on the version and on mono (channel mode 3)
+	MP3FrameHeader header(frame);
+	bool isMono = (frame[3] >> 6) == 3;
+	uint64_t sideInfoSize = header.getMPEGVersion() == MP3FrameHeader::MPEG1 ? (isMono ? 17 : 32) : (isMono ? 9 : 17);
+
+	return parseXing(frame, size, 4 + sideInfoSize) || parseVBRI(frame, size);
+}
+
+MP3VBRHeader::Type MP3VBRHeader::getType() const {
+	return type;
+}
+
+bool MP3VBRHeader::hasFrameCount() const {
+	return frameCount > 0;
+}
+
+uint32_t MP3VBRHeader::getFrameCount() const {
+	return frameCount;
+}
+
+bool MP3VBRHeader::hasByteCount() const {
+	return byteCount > 0;
+}
+
+uint32_t MP3VBRHeader::getByteCount() const {
+	return byteCount;
+}
+
+bool MP3VBRHeader::hasTOC() const {
+	return !toc.empty();
+}
+
+uint64_t MP3VBRHeader::getSeekOffset(double fraction) const {
+	fraction = fraction < 0.0 ? 0.0 : fraction > 1.0 ? 1.0 : fraction;
+	if (toc.empty()) {
+		return static_cast<uint64_t>(fraction * byteCount);
+	}
+
+	// Offsets between two entries are interpolated
+	double position = fraction * (toc.size() - 1);
+	std::size_t entry = static_cast<std::size_t>(position);
+	if (entry + 1 >= toc.size()) {
+		return toc.back();
+	}
+	double between = position - entry;
+	return toc[entry] + static_cast<uint64_t>(between * (toc[entry + 1] - toc[entry]));
+}
+
+bool MP3VBRHeader::hasEncoderDelay() const {
+	return hasDelay;
+}
+
+uint16_t MP3VBRHeader::getEncoderDelay() const {
+	return encoderDelay;
+}
+
+uint16_t MP3VBRHeader::getEncoderPadding() const {
+	return encoderPadding;
+}
+
+bool MP3VBRHeader::parseXing(const uint8_t* frame, uint64_t size, uint64_t offset) {
+	if (offset + 8 > size) {
+		return false;
+	}
+	bool isXing = std::memcmp(&frame[offset], "Xing", 4) == 0;
+	bool isInfo = std::memcmp(&frame[offset], "Info", 4) == 0;
+	if (!isXing && !isInfo) {
+		return false;
+	}
+
+	uint32_t flags = readBigEndian(&frame[offset + 4], 4);
+	uint64_t position = offset + 8;
+	uint64_t fieldsSize = ((flags & XING_FRAMES) ? 4 : 0) + ((flags & XING_BYTES) ? 4 : 0) +
+		((flags & XING_TOC) ? 100 : 0) + ((flags & XING_QUALITY) ? 4 : 0);
+	if (position + fieldsSize > size) {
+		return false;
+	}
+
+	type = isXing ? Xing : Info;
+	if (flags & XING_FRAMES) {
+		frameCount = readBigEndian(&frame[position], 4);
+		position += 4;
+	}
+	if (flags & XING_BYTES) {
+		byteCount = readBigEndian(&frame[position], 4);
+		position += 4;
+	}
+	if (flags & XING_TOC) {
+		// Each of the 100 entries is the offset at that percent of the duration, in 256ths of the byte count
+		if (byteCount > 0) {
+			toc.resize(101);
+			for (std::size_t i = 0; i < 100; i++) {
+				toc[i] = static_cast<uint64_t>(frame[position + i]) * byteCount / 256;
+			}
+			toc[100] = byteCount;
+		}
+		position += 100;
+	}
+	if (flags & XING_QUALITY) {
+		position += 4;
+	}
+
+	// LAME extension: 9 bytes of encoder name, then the delay and padding as two 12-bit numbers 21 bytes in
+	if (position + 24 <= size && (std::memcmp(&frame[position], "LAME", 4) == 0 || std::memcmp(&frame[position], "Lav", 3) == 0)) {
+		uint32_t delayAndPadding = readBigEndian(&frame[position + 21], 3);
+		encoderDelay = static_cast<uint16_t>(delayAndPadding >> 12);
+		encoderPadding = static_cast<uint16_t>(delayAndPadding & 0x0FFF);
+		hasDelay = true;
+	}
+
+	return true;
+}
+
+bool MP3VBRHeader::parseVBRI(const uint8_t* frame, uint64_t size) {
+	if (VBRI_OFFSET + 26 > size || std::memcmp(&frame[VBRI_OFFSET], "VBRI", 4) != 0) {
+		return false;
+	}
+
+	const uint8_t* vbri = &frame[VBRI_OFFSET];
+	type = VBRI;
+	byteCount = readBigEndian(&vbri[10], 4);
+	frameCount = readBigEndian(&vbri[14], 4);
+
+	// Each entry is the size of a segment of the same number of frames, scaled
+	uint32_t entries = readBigEndian(&vbri[18], 2);
+	uint32_t scale = readBigEndian(&vbri[20], 2);
+	uint32_t entrySize = readBigEndian(&vbri[22], 2);
+	if (entries > 0 && entrySize >= 1 && entrySize <= 4 && VBRI_OFFSET + 26 + static_cast<uint64_t>(entries) * entrySize <= size) {
+		toc.resize(entries + 1);
+		toc[0] = 0;
+		for (uint32_t i = 0; i < entries; i++) {
+			toc[i + 1] = toc[i] + static_cast<uint64_t>(readBigEndian(&vbri[26 + i * entrySize], entrySize)) * scale;
+		}
+	}
+
+	return true;
+}
+
+MP3StreamInfo::MP3StreamInfo()
+	: source(None), firstFrame(), vbrHeader(), audioOffset(0), audioSize(0), frameCount(0), sampleCount(0),
+	sampleRate(0), durationMs(0.0), averageBitrate(0) {
+}
+
+MP3StreamInfo::~MP3StreamInfo() {
+}
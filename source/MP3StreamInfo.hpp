@@ -0,0 +1,251 @@
+#ifndef MP3STREAMINFO_HPP
+#define MP3STREAMINFO_HPP
+
+/**
+ * @file MP3StreamInfo.hpp
+ *
+ * @author Evandro L. Vieira
+ *
+ * @brief This file contains the definition of the classes MP3VBRHeader and MP3StreamInfo.
+ */
+
+#include "MP3FrameHeader.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class MP3VBRHeader
+ *
+ * @brief Xing/Info or VBRI header of the first audio frame, with the LAME extension of a Xing/Info header.
+ *
+ * Encoders write it in a frame without audio at the start of the stream: the number of frames and bytes of the
+ * stream, a table of contents for seeking and, for LAME and FFmpeg, the encoder delay and padding in samples.
+ */
+class MP3VBRHeader {
+	public:
+		/**
+		 * @enum MP3VBRHeader::Type
+		 *
+		 * @brief Kind of header found.
+		 */
+		enum Type {
+			None = 0,	/**< No header, the frame holds audio. */
+			Xing = 1,	/**< "Xing" header of a variable bitrate stream. */
+			Info = 2,	/**< "Info" header, the same layout written for a constant bitrate stream. */
+			VBRI = 3	/**< Fraunhofer "VBRI" header. */
+		};
+
+		/**
+		 * @brief Default constructor, no header.
+		 */
+		MP3VBRHeader();
+
+		/**
+		 * @brief Virtual destructor.
+		 */
+		virtual ~MP3VBRHeader();
+
+		/**
+		 * @brief Read the header of a frame, if it has one.
+		 *
+		 * @param frame Pointer to the frame, starting with its 4-byte header.
+		 * @param size Number of bytes available from frame.
+		 *
+		 * @return true if a Xing, Info or VBRI header was found, false otherwise.
+		 */
+		bool parse(const uint8_t* frame, uint64_t size);
+
+		/**
+		 * @brief Get the kind of header found by parse().
+		 *
+		 * @return The header type, None if there is none.
+		 */
+		Type getType() const;
+
+		/**
+		 * @brief Check if the header gives the number of frames.
+		 *
+		 * @return true if getFrameCount() is known, false otherwise.
+		 */
+		bool hasFrameCount() const;
+
+		/**
+		 * @brief Get the number of audio frames of the stream, without the frame holding the header.
+		 *
+		 * @return Number of frames, 0 if unknown.
+		 */
+		uint32_t getFrameCount() const;
+
+		/**
+		 * @brief Check if the header gives the size of the stream.
+		 *
+		 * @return true if getByteCount() is known, false otherwise.
+		 */
+		bool hasByteCount() const;
+
+		/**
+		 * @brief Get the size of the stream, from the frame holding the header.
+		 *
+		 * @return Size in bytes, 0 if unknown.
+		 */
+		uint32_t getByteCount() const;
+
+		/**
+		 * @brief Check if the header has a table of contents for seeking.
+		 *
+		 * @return true if getSeekOffset() uses one, false otherwise.
+		 */
+		bool hasTOC() const;
+
+		/**
+		 * @brief Get the byte offset of a position in the stream from the table of contents.
+		 *
+		 * @param fraction Position from 0.0 (start) to 1.0 (end) of the duration.
+		 *
+		 * @return Offset from the frame holding the header, proportional to the byte count without a table.
+		 */
+		uint64_t getSeekOffset(double fraction) const;
+
+		/**
+		 * @brief Check if a LAME extension gives the encoder delay and padding.
+		 *
+		 * @return true if found, false otherwise.
+		 */
+		bool hasEncoderDelay() const;
+
+		/**
+		 * @brief Get the samples added by the encoder before the audio.
+		 *
+		 * @return Samples per channel, 0 if unknown.
+		 */
+		uint16_t getEncoderDelay() const;
+
+		/**
+		 * @brief Get the samples added by the encoder after the audio to fill the last frame.
+		 *
+		 * @return Samples per channel, 0 if unknown.
+		 */
+		uint16_t getEncoderPadding() const;
+
+	private:
+		/**
+		 * @brief Read a Xing or Info header and its LAME extension at the given offset of the frame.
+		 */
+		bool parseXing(const uint8_t* frame, uint64_t size, uint64_t offset);
+
+		/**
+		 * @brief Read a VBRI header, always 32 bytes after the frame header.
+		 */
+		bool parseVBRI(const uint8_t* frame, uint64_t size);
+
+		Type type;					///< Kind of header found.
+		uint32_t frameCount;		///< Number of frames, 0 if unknown.
+		uint32_t byteCount;			///< Size of the stream, 0 if unknown.
+		std::vector<uint64_t> toc;	///< Offsets at evenly spaced positions of the duration, first 0 and last byteCount.
+		bool hasDelay;				///< Whether a LAME extension was found.
+		uint16_t encoderDelay;		///< Encoder delay in samples.
+		uint16_t encoderPadding;	///< Encoder padding in samples.
+};
+
+/**
+ * @class MP3StreamInfo
+ *
+ * @brief Duration and average bitrate of an MP3 stream, see MP3File::getStreamInfo().
+ */
+class MP3StreamInfo {
+	public:
+		/**
+		 * @enum MP3StreamInfo::Source
+		 *
+		 * @brief Where the values come from, from the cheapest to the most expensive.
+		 */
+		enum Source {
+			None = 0,				/**< Nothing known, no audio frame found. */
+			VBRHeader = 1,			/**< The Xing/Info or VBRI header of the first frame. */
+			ConstantBitrate = 2,	/**< The audio size at the bitrate of the first frames. */
+			FrameIndex = 3			/**< All frames, see MP3File::getMP3(). */
+		};
+
+		/**
+		 * @brief Default constructor, nothing known.
+		 */
+		MP3StreamInfo();
+
+		/**
+		 * @brief Virtual destructor.
+		 */
+		virtual ~MP3StreamInfo();
+
+		/**
+		 * @var MP3StreamInfo::Source MP3StreamInfo::source
+		 *
+		 * @brief Where the values come from.
+		 */
+		Source source;
+
+		/**
+		 * @var MP3FrameHeader MP3StreamInfo::firstFrame
+		 *
+		 * @brief Header of the first audio frame, the one holding the VBR header if any.
+		 */
+		MP3FrameHeader firstFrame;
+
+		/**
+		 * @var MP3VBRHeader MP3StreamInfo::vbrHeader
+		 *
+		 * @brief VBR header of the first frame, of type MP3VBRHeader::None if it has none.
+		 */
+		MP3VBRHeader vbrHeader;
+
+		/**
+		 * @var uint64_t MP3StreamInfo::audioOffset
+		 *
+		 * @brief File offset of the first audio frame.
+		 */
+		uint64_t audioOffset;
+
+		/**
+		 * @var uint64_t MP3StreamInfo::audioSize
+		 *
+		 * @brief Size of the audio from the first frame, up to the tags at the end.
+		 */
+		uint64_t audioSize;
+
+		/**
+		 * @var uint64_t MP3StreamInfo::frameCount
+		 *
+		 * @brief Number of audio frames, estimated for MP3StreamInfo::ConstantBitrate.
+		 */
+		uint64_t frameCount;
+
+		/**
+		 * @var uint64_t MP3StreamInfo::sampleCount
+		 *
+		 * @brief Samples per channel, without the encoder delay and padding when the LAME extension gives them.
+		 */
+		uint64_t sampleCount;
+
+		/**
+		 * @var uint32_t MP3StreamInfo::sampleRate
+		 *
+		 * @brief Sample rate in Hz.
+		 */
+		uint32_t sampleRate;
+
+		/**
+		 * @var double MP3StreamInfo::durationMs
+		 *
+		 * @brief Duration in milliseconds.
+		 */
+		double durationMs;
+
+		/**
+		 * @var uint32_t MP3StreamInfo::averageBitrate
+		 *
+		 * @brief Average bitrate in kbps.
+		 */
+		uint32_t averageBitrate;
+};
+
+#endif /* MP3STREAMINFO_HPP */
@@ -0,0 +1,303 @@
+#include "RecordWriter.hpp"
+
+#include <cstdio>
+
+/**
+ * @brief Columns of a record after path, size, status, versions and tag sizes: the core fields by frame identifier.
+ *
+ * The fields are read by their ID3v2.3 identifier whatever the tag version, so "TYER" also holds the TDRC timestamp
+ * of an ID3v2.4 tag, of which only the year is kept.
+ */
+static const struct{
+	const char* name;
+	const char* identifier;
+	std::size_t length;	///< Characters kept, 0 for all.
+} FIELD_COLUMNS[] = {
+	{"title", "TIT2", 0},
+	{"artist", "TPE1", 0},
+	{"album", "TALB", 0},
+	{"year", "TYER", 4},
+	{"track", "TRCK", 0},
+	{"genre", "TCON", 0}
+};
+
+/**
+ * @brief Names of the TagProbe::Version bits listed in the versions column.
+ */
+static const struct{
+	TagProbe::Version version;
+	const char* name;
+} VERSION_NAMES[] = {
+	{TagProbe::ID3v10, "ID3v1.0"},
+	{TagProbe::ID3v11, "ID3v1.1"},
+	{TagProbe::ID3v20, "ID3v2.0"},
+	{TagProbe::ID3v23, "ID3v2.3"},
+	{TagProbe::ID3v24, "ID3v2.4"},
+	{TagProbe::ID3v24Appended, "ID3v2.4-appended"}
+};
+
+/**
+ * @brief Append a code point as UTF-8.
+ */
+static void appendUTF8(std::string& out, uint32_t codePoint){
+	if(codePoint < 0x80){
+		out += static_cast<char>(codePoint);
+	}else if(codePoint < 0x800){
+		out += static_cast<char>(0xC0 | (codePoint >> 6));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}else if(codePoint < 0x10000){
+		out += static_cast<char>(0xE0 | (codePoint >> 12));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}else{
+		out += static_cast<char>(0xF0 | (codePoint >> 18));
+		out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+}
+
+/**
+ * @brief Decode UTF-16 up to the first NUL character, unpaired surrogates become U+FFFD.
+ */
+static std::string decodeUTF16(const uint8_t* in, std::size_t size, bool isBigEndian){
+	std::string out;
+	for(std::size_t i = 0; i + 1 < size; i += 2){
+		uint32_t unit = isBigEndian == true ? (in[i] << 8 | in[i + 1]) : (in[i + 1] << 8 | in[i]);
+		if(unit == 0){
+			break;
+		}
+		if(unit >= 0xD800 && unit < 0xDC00 && i + 3 < size){
+			uint32_t low = isBigEndian == true ? (in[i + 2] << 8 | in[i + 3]) : (in[i + 3] << 8 | in[i + 2]);
+			if(low >= 0xDC00 && low < 0xE000){
+				appendUTF8(out, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+				i += 2;
+				continue;
+			}
+		}
+		appendUTF8(out, unit >= 0xD800 && unit < 0xE000 ? 0xFFFD : unit);
+	}
+	return out;
+}
+
+bool RecordWriter::parseFormat(const std::string& name, Format& format){
+	if(name == "jsonl"){
+		format = JSONLines;
+	}else if(name == "csv"){
+		format = CSV;
+	}else if(name == "tsv"){
+		format = TSV;
+	}else{
+		return false;
+	}
+	return true;
+}
+
+RecordWriter::RecordWriter(std::ostream& stream, Format format, std::size_t bufferSize) :
+	stream(stream), format(format), bufferSize(bufferSize){
+	buffer.reserve(bufferSize + 4096);
+
+	if(format != JSONLines){
+		const char* separator = format == CSV ? "," : "\t";
+		buffer += "path";
+		buffer += separator;
+		buffer += "size";
+		buffer += separator;
+		buffer += "status";
+		buffer += separator;
+		buffer += "versions";
+		buffer += separator;
+		buffer += "id3v2_size";
+		buffer += separator;
+		buffer += "id3v1_size";
+		buffer += separator;
+		buffer += "appended_size";
+		for(const auto& column : FIELD_COLUMNS){
+			buffer += separator;
+			buffer += column.name;
+		}
+		buffer += '\n';
+	}
+}
+
+RecordWriter::~RecordWriter(){
+	flush();
+}
+
+void RecordWriter::write(const std::string& path, const TagProbe& probe, const std::map<std::string, std::string>& fields){
+	std::string versions;
+	for(const auto& version : VERSION_NAMES){
+		if(probe.has(version.version) == true){
+			if(format == JSONLines){
+				versions += versions.empty() == true ? "\"" : ",\"";
+				versions += version.name;
+				versions += '"';
+			}else{
+				versions += versions.empty() == true ? "" : " ";
+				versions += version.name;
+			}
+		}
+	}
+	if(format == JSONLines){
+		versions = "[" + versions + "]";
+	}
+
+	add("path", path, false, true);
+	add("size", std::to_string(probe.fileSize), true, false);
+	add("status", "ok", false, false);
+	add("versions", versions, format == JSONLines, false);
+	add("id3v2_size", std::to_string(probe.id3v2Size), true, false);
+	add("id3v1_size", std::to_string(probe.hasID3v1() == true ? 128 : 0), true, false);
+	add("appended_size", std::to_string(probe.appendedSize), true, false);
+	for(const auto& column : FIELD_COLUMNS){
+		auto field = fields.find(column.identifier);
+		std::string value = field != fields.end() ? decodeText(field->second) : std::string();
+		if(column.length > 0 && value.size() > column.length){
+			value.resize(column.length);
+		}
+		add(column.name, value, false, false);
+	}
+	endRecord();
+}
+
+void RecordWriter::writeFailure(const std::string& path){
+	add("path", path, false, true);
+	if(format == JSONLines){
+		add("status", "failed", false, false);
+	}else{
+		// Every line of CSV and TSV has all the columns, the ones after status are empty
+		add("size", "", true, false);
+		add("status", "failed", false, false);
+		for(std::size_t i = 0; i < 4 + sizeof(FIELD_COLUMNS) / sizeof(FIELD_COLUMNS[0]); i++){
+			add("", "", true, false);
+		}
+	}
+	endRecord();
+}
+
+bool RecordWriter::flush(){
+	if(buffer.empty() == false){
+		stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		buffer.clear();
+	}
+	stream.flush();
+	return stream.good();
+}
+
+std::string RecordWriter::decodeText(const std::string& payload){
+	const uint8_t* in = reinterpret_cast<const uint8_t*>(payload.data());
+	std::size_t size = payload.size();
+	if(size == 0){
+		return std::string();
+	}
+
+	uint8_t encoding = 0;
+	if(in[0] < 4){
+		encoding = in[0];
+		in++;
+		size--;
+	}
+
+	std::string out;
+	switch(encoding){
+		case 1:
+			if(size >= 2 && in[0] == 0xFF && in[1] == 0xFE){
+				return decodeUTF16(in + 2, size - 2, false);
+			}
+			if(size >= 2 && in[0] == 0xFE && in[1] == 0xFF){
+				return decodeUTF16(in + 2, size - 2, true);
+			}
+			return decodeUTF16(in, size, true);
+		case 2:
+			return decodeUTF16(in, size, true);
+		case 3:
+			for(std::size_t i = 0; i < size && in[i] != 0; i++){
+				out += static_cast<char>(in[i]);
+			}
+			return out;
+		default:
+			for(std::size_t i = 0; i < size && in[i] != 0; i++){
+				appendUTF8(out, in[i]);
+			}
+			return out;
+	}
+}
+
+void RecordWriter::add(const char* name, const std::string& value, bool isNumber, bool isFirst){
+	if(format == JSONLines){
+		buffer += isFirst == true ? "{\"" : ",\"";
+		buffer += name;
+		buffer += "\":";
+		if(isNumber == true){
+			buffer += value;
+			return;
+		}
+
+		buffer += '"';
+		for(unsigned char character : value){
+			switch(character){
+				case '"': buffer += "\\\""; break;
+				case '\\': buffer += "\\\\"; break;
+				case '\n': buffer += "\\n"; break;
+				case '\r': buffer += "\\r"; break;
+				case '\t': buffer += "\\t"; break;
+				default:
+					if(character < 0x20){
+						char escaped[7];
+						std::snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+						buffer += escaped;
+					}else{
+						buffer += static_cast<char>(character);
+					}
+					break;
+			}
+		}
+		buffer += '"';
+		return;
+	}
+
+	if(format == CSV){
+		if(isFirst == false){
+			buffer += ',';
+		}
+		if(value.find_first_of(",\"\r\n") == std::string::npos){
+			buffer += value;
+			return;
+		}
+
+		buffer += '"';
+		for(char character : value){
+			if(character == '"'){
+				buffer += '"';
+			}
+			buffer += character;
+		}
+		buffer += '"';
+		return;
+	}
+
+	if(isFirst == false){
+		buffer += '\t';
+	}
+	for(char character : value){
+		switch(character){
+			case '\t': buffer += "\\t"; break;
+			case '\n': buffer += "\\n"; break;
+			case '\r': buffer += "\\r"; break;
+			case '\\': buffer += "\\\\"; break;
+			default: buffer += character; break;
+		}
+	}
+}
+
+void RecordWriter::endRecord(){
+	if(format == JSONLines){
+		buffer += '}';
+	}
+	buffer += '\n';
+
+	if(buffer.size() >= bufferSize){
+		stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		buffer.clear();
+	}
+}
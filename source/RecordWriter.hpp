@@ -0,0 +1,119 @@
+#ifndef RECORDWRITER_HPP
+#define RECORDWRITER_HPP
+
+/**
+ * @file RecordWriter.hpp
+ *
+ * @author Evandro L. Vieira
+ *
+ * @brief This file contains the definition of the class RecordWriter.
+ */
+
+#include "TagProbe.hpp"
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * @class RecordWriter
+ *
+ * @brief Machine readable output of the tags of files, one record per file, as JSON Lines, CSV or TSV.
+ *
+ * Records are formatted into a large buffer written to the stream in big chunks, never flushed per record,
+ * so writing to a pipe costs one system call per buffer instead of one per file. Each record has the path,
+ * size, tag versions, tag sizes and the core text fields decoded to UTF-8.
+ */
+class RecordWriter{
+	public:
+		/**
+		 * @enum RecordWriter::Format
+		 *
+		 * @brief Output formats.
+		 */
+		enum Format{
+			JSONLines,	/**< One JSON object per line. */
+			CSV,		/**< Comma separated values with a header line, RFC 4180 quoting. */
+			TSV			/**< Tab separated values with a header line, tabs, newlines and backslashes escaped. */
+		};
+
+		/**
+		 * @brief Get the format of the given name.
+		 *
+		 * @param name "jsonl", "csv" or "tsv".
+		 * @param format Set to the format when the name is known.
+		 *
+		 * @return true if known, false otherwise.
+		 */
+		static bool parseFormat(const std::string& name, Format& format);
+
+		/**
+		 * @brief Constructor that writes the header line of CSV and TSV.
+		 *
+		 * @param stream The stream to write to.
+		 * @param format The output format.
+		 * @param bufferSize Bytes buffered before they are written to stream.
+		 */
+		RecordWriter(std::ostream& stream, Format format, std::size_t bufferSize = 1024 * 1024);
+
+		/**
+		 * @brief Virtual destructor that writes the records still buffered.
+		 */
+		virtual ~RecordWriter();
+
+		/**
+		 * @brief Add the record of a file.
+		 *
+		 * @param path The file path.
+		 * @param probe The tags found in the file.
+		 * @param fields The core fields by frame identifier, payloads as returned by MP3File::getFields().
+		 */
+		void write(const std::string& path, const TagProbe& probe, const std::map<std::string, std::string>& fields);
+
+		/**
+		 * @brief Add the record of a file that could not be read.
+		 *
+		 * @param path The file path.
+		 */
+		void writeFailure(const std::string& path);
+
+		/**
+		 * @brief Write the buffered records to the stream and flush it.
+		 *
+		 * @return true if the stream is still good, false otherwise.
+		 */
+		bool flush();
+
+		/**
+		 * @brief Decode the payload of a text frame, or an ID3v1 field, to UTF-8.
+		 *
+		 * A payload starting with an ID3v2 text encoding byte (0 ISO-8859-1, 1 UTF-16 with BOM, 2 UTF-16BE, 3 UTF-8)
+		 * is decoded accordingly, anything else is read as ISO-8859-1. The text ends at the first NUL character,
+		 * dropping the terminator, the padding of ID3v1 fields and further values of an ID3v2.4 frame.
+		 *
+		 * @param payload The payload.
+		 *
+		 * @return The text in UTF-8.
+		 */
+		static std::string decodeText(const std::string& payload);
+
+	private:
+		/**
+		 * @brief Add one value, quoted or escaped for the format, preceded by a separator unless it is the first of the record.
+		 */
+		void add(const char* name, const std::string& value, bool isNumber, bool isFirst);
+
+		/**
+		 * @brief End the record and write the buffer when it is full.
+		 */
+		void endRecord();
+
+	private:
+		std::ostream& stream;	///< Where records are written.
+		Format format;			///< The output format.
+		std::size_t bufferSize;	///< Bytes buffered before a write.
+		std::string buffer;		///< Records not written yet.
+};
+
+#endif /* RECORDWRITER_HPP */
@@ -0,0 +1,338 @@
+#include "ScanCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#ifndef _WIN32
+	#include <sys/stat.h>
+#endif
+
+/**
+ * @brief First bytes of a cache file.
+ */
+static const uint8_t CACHE_MAGIC[4] = {'I', 'D', '3', 'C'};
+
+/**
+ * @brief Format version of a cache file, files of other versions are ignored.
+ */
+static const uint32_t CACHE_VERSION = 2;
+
+/**
+ * @brief 64 bit FNV-1a hash of the given bytes.
+ */
+static uint64_t hashBytes(const void* bytes, std::size_t size, uint64_t hash = 0xCBF29CE484222325ULL){
+	const uint8_t* in = static_cast<const uint8_t*>(bytes);
+	for(std::size_t i = 0; i < size; i++){
+		hash ^= in[i];
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+/**
+ * @brief Append an unsigned integer of the given number of bytes, little endian.
+ */
+static void putInteger(std::vector<uint8_t>& out, uint64_t value, int bytes){
+	for(int i = 0; i < bytes; i++){
+		out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+	}
+}
+
+/**
+ * @brief Read an unsigned integer of the given number of bytes, little endian, false past the end of in.
+ */
+static bool getInteger(const std::vector<uint8_t>& in, std::size_t& position, uint64_t& value, int bytes){
+	if(in.size() - position < static_cast<std::size_t>(bytes)){
+		return false;
+	}
+	value = 0;
+	for(int i = 0; i < bytes; i++){
+		value |= static_cast<uint64_t>(in[position++]) << (8 * i);
+	}
+	return true;
+}
+
+/**
+ * @brief Read a string of the given length, false past the end of in.
+ */
+static bool getString(const std::vector<uint8_t>& in, std::size_t& position, std::string& value, uint64_t length){
+	if(in.size() - position < length){
+		return false;
+	}
+	value.assign(reinterpret_cast<const char*>(&in[position]), static_cast<std::size_t>(length));
+	position += static_cast<std::size_t>(length);
+	return true;
+}
+
+const std::vector<std::string> ScanCache::CORE_FIELDS = {"TIT2", "TPE1", "TALB", "TYER", "TRCK", "TCON"};
+
+bool ScanCache::Key::operator==(const Key& other) const{
+	return device == other.device && inode == other.inode && size == other.size && modified == other.modified;
+}
+
+std::size_t ScanCache::KeyHash::operator()(const Key& key) const{
+	uint64_t hash = hashBytes(&key.device, sizeof(key.device));
+	hash = hashBytes(&key.inode, sizeof(key.inode), hash);
+	hash = hashBytes(&key.size, sizeof(key.size), hash);
+	hash = hashBytes(&key.modified, sizeof(key.modified), hash);
+	return static_cast<std::size_t>(hash);
+}
+
+ScanCache::ScanCache() :
+	hits(0), misses(0){
+
+}
+
+ScanCache::~ScanCache(){
+
+}
+
+std::filesystem::path ScanCache::getDefaultPath(const std::filesystem::path& library){
+	std::error_code error;
+	std::filesystem::path canonical = std::filesystem::canonical(library, error);
+	if(error){
+		canonical = std::filesystem::absolute(library, error);
+	}
+
+	std::string name = canonical.u8string();
+	char hash[17];
+	std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hashBytes(name.data(), name.size())));
+
+	std::filesystem::path directory;
+#ifdef _WIN32
+	const char* localAppData = std::getenv("LOCALAPPDATA");
+	if(localAppData != nullptr && localAppData[0] != '\0'){
+		directory = std::filesystem::path(localAppData) / "id3";
+	}
+#else
+	const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+	const char* home = std::getenv("HOME");
+	if(cacheHome != nullptr && cacheHome[0] == '/'){
+		directory = std::filesystem::path(cacheHome) / "id3";
+	}else if(home != nullptr && home[0] != '\0'){
+		directory = std::filesystem::path(home) / ".cache" / "id3";
+	}
+#endif
+
+	if(directory.empty() == true){
+		return library / ".id3_scan_cache";
+	}
+	return directory / ("scan-" + std::string(hash) + ".cache");
+}
+
+bool ScanCache::getKey(const std::filesystem::path& file, Key& key){
+#ifndef _WIN32
+	struct stat status;
+	if(stat(file.c_str(), &status) != 0){
+		return false;
+	}
+
+	key.device = static_cast<uint64_t>(status.st_dev);
+	key.inode = static_cast<uint64_t>(status.st_ino);
+	key.size = static_cast<uint64_t>(status.st_size);
+#ifdef __APPLE__
+	key.modified = static_cast<int64_t>(status.st_mtimespec.tv_sec) * 1000000000 + status.st_mtimespec.tv_nsec;
+#else
+	key.modified = static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+#endif
+#else
+	std::error_code error;
+	key.size = std::filesystem::file_size(file, error);
+	if(error){
+		return false;
+	}
+	std::filesystem::file_time_type modified = std::filesystem::last_write_time(file, error);
+	if(error){
+		return false;
+	}
+	key.modified = std::chrono::duration_cast<std::chrono::nanoseconds>(modified.time_since_epoch()).count();
+
+	std::wstring canonical = std::filesystem::canonical(file, error).wstring();
+	key.device = 0;
+	key.inode = hashBytes(canonical.data(), canonical.size() * sizeof(wchar_t));
+#endif
+
+	return true;
+}
+
+bool ScanCache::load(const std::filesystem::path& file){
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+
+	std::ifstream stream(file, std::ios::in | std::ios::binary);
+	if(stream.is_open() == false){
+		return false;
+	}
+	std::vector<uint8_t> in((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	std::size_t position = sizeof(CACHE_MAGIC);
+	uint64_t version = 0;
+	uint64_t count = 0;
+	if(in.size() < position || std::equal(CACHE_MAGIC, CACHE_MAGIC + sizeof(CACHE_MAGIC), in.begin()) == false){
+		return false;
+	}
+	if(getInteger(in, position, version, 4) == false || version != CACHE_VERSION || getInteger(in, position, count, 8) == false){
+		return false;
+	}
+
+	entries.reserve(static_cast<std::size_t>(count < in.size() ? count : in.size()));
+	for(uint64_t i = 0; i < count; i++){
+		Key key;
+		Slot slot;
+		uint64_t device, inode, size, modified, versions, fieldCount;
+		TagProbe& probe = slot.entry.probe;
+		bool valid = getInteger(in, position, device, 8) && getInteger(in, position, inode, 8) &&
+			getInteger(in, position, size, 8) && getInteger(in, position, modified, 8) &&
+			getInteger(in, position, versions, 4) && getInteger(in, position, probe.id3v2Size, 8) &&
+			getInteger(in, position, probe.id3v1Offset, 8) && getInteger(in, position, probe.appendedOffset, 8) &&
+			getInteger(in, position, probe.appendedSize, 8) && getInteger(in, position, probe.fileSize, 8) &&
+			getInteger(in, position, fieldCount, 1);
+
+		for(uint64_t j = 0; valid == true && j < fieldCount; j++){
+			uint64_t identifierLength, valueLength;
+			std::string identifier, value;
+			valid = getInteger(in, position, identifierLength, 1) && getString(in, position, identifier, identifierLength) &&
+				getInteger(in, position, valueLength, 4) && getString(in, position, value, valueLength);
+			slot.entry.fields[identifier] = value;
+		}
+
+		if(valid == false){
+			entries.clear();
+			return false;
+		}
+
+		key.device = device;
+		key.inode = inode;
+		key.size = size;
+		key.modified = static_cast<int64_t>(modified);
+		probe.versions = static_cast<uint32_t>(versions);
+		slot.used = false;
+		entries[key] = std::move(slot);
+	}
+
+	hits = 0;
+	misses = 0;
+
+	return true;
+}
+
+bool ScanCache::save(const std::filesystem::path& file){
+	std::vector<uint8_t> out;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		uint64_t count = 0;
+		for(const auto& item : entries){
+			if(item.second.used == true){
+				count++;
+			}
+		}
+
+		out.insert(out.end(), CACHE_MAGIC, CACHE_MAGIC + sizeof(CACHE_MAGIC));
+		putInteger(out, CACHE_VERSION, 4);
+		putInteger(out, count, 8);
+
+		for(const auto& item : entries){
+			if(item.second.used == false){
+				continue;
+			}
+
+			const Key& key = item.first;
+			const TagProbe& probe = item.second.entry.probe;
+			putInteger(out, key.device, 8);
+			putInteger(out, key.inode, 8);
+			putInteger(out, key.size, 8);
+			putInteger(out, static_cast<uint64_t>(key.modified), 8);
+			putInteger(out, probe.versions, 4);
+			putInteger(out, probe.id3v2Size, 8);
+			putInteger(out, probe.id3v1Offset, 8);
+			putInteger(out, probe.appendedOffset, 8);
+			putInteger(out, probe.appendedSize, 8);
+			putInteger(out, probe.fileSize, 8);
+
+			// Identifiers are frame identifiers and values are clipped, so both lengths fit their field
+			const auto& fields = item.second.entry.fields;
+			uint64_t fieldCount = fields.size() < 0xFF ? fields.size() : 0xFF;
+			putInteger(out, fieldCount, 1);
+			for(auto field = fields.begin(); fieldCount > 0; ++field, fieldCount--){
+				std::size_t identifierLength = field->first.size() < 0xFF ? field->first.size() : 0xFF;
+				std::size_t valueLength = field->second.size() < 0xFFFFFFFF ? field->second.size() : 0xFFFFFFFF;
+				putInteger(out, identifierLength, 1);
+				out.insert(out.end(), field->first.begin(), field->first.begin() + identifierLength);
+				putInteger(out, valueLength, 4);
+				out.insert(out.end(), field->second.begin(), field->second.begin() + valueLength);
+			}
+		}
+	}
+
+	std::error_code error;
+	if(file.has_parent_path() == true){
+		std::filesystem::create_directories(file.parent_path(), error);
+	}
+
+	std::filesystem::path temporary = file;
+	temporary += ".tmp";
+	{
+		std::ofstream stream(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+		if(stream.is_open() == false){
+			return false;
+		}
+		stream.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+		if(stream.fail() == true){
+			stream.close();
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporary, file, error);
+	if(error){
+		std::filesystem::remove(temporary, error);
+		return false;
+	}
+
+	return true;
+}
+
+bool ScanCache::find(const Key& key, Entry& entry){
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto it = entries.find(key);
+	if(it == entries.end()){
+		misses++;
+		return false;
+	}
+
+	it->second.used = true;
+	entry = it->second.entry;
+	hits++;
+	return true;
+}
+
+void ScanCache::store(const Key& key, const Entry& entry){
+	std::lock_guard<std::mutex> lock(mutex);
+
+	Slot& slot = entries[key];
+	slot.entry = entry;
+	slot.used = true;
+}
+
+std::size_t ScanCache::getSize() const{
+	std::lock_guard<std::mutex> lock(mutex);
+	return entries.size();
+}
+
+uint64_t ScanCache::getHits() const{
+	std::lock_guard<std::mutex> lock(mutex);
+	return hits;
+}
+
+uint64_t ScanCache::getMisses() const{
+	std::lock_guard<std::mutex> lock(mutex);
+	return misses;
+}
@@ -0,0 +1,171 @@
+#ifndef SCANCACHE_HPP
+#define SCANCACHE_HPP
+
+/**
+ * @file ScanCache.hpp
+ *
+ * @author Evandro L. Vieira
+ *
+ * @brief This file contains the definition of the class ScanCache.
+ */
+
+#include "TagProbe.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class ScanCache
+ *
+ * @brief Persistent cache of the tags found in files, so an unchanged file is not read again.
+ *
+ * Entries are keyed by the identity and state of a file on disk: device, inode, size and modification time in
+ * nanoseconds. A file that was not changed since it was cached costs a single stat(), a renamed or moved file
+ * keeps its entry and a rewritten one misses it. The cache is safe to use from several threads.
+ */
+class ScanCache{
+	public:
+		/**
+		 * @brief Identity and state of a file on disk.
+		 */
+		struct Key{
+			uint64_t device;		///< Device of the file.
+			uint64_t inode;			///< Inode of the file, a hash of its canonical path on Windows.
+			uint64_t size;			///< Size of the file in bytes.
+			int64_t modified;		///< Modification time in nanoseconds.
+
+			bool operator==(const Key& other) const;
+		};
+
+		/**
+		 * @brief What is cached for a file.
+		 */
+		struct Entry{
+			TagProbe probe;								///< Tags found in the file.
+			std::map<std::string, std::string> fields;	///< Core fields read from the tags, see CORE_FIELDS.
+		};
+
+		/**
+		 * @brief Frame identifiers of the core fields cached for each file: title, artist, album, year, track and genre.
+		 *
+		 * They are ID3v2.3 identifiers, the year "TYER" being read from "TDRC" in an ID3v2.4 tag.
+		 */
+		static const std::vector<std::string> CORE_FIELDS;
+
+		/**
+		 * @brief Default constructor, an empty cache.
+		 */
+		ScanCache();
+
+		/**
+		 * @brief Default virtual destructor.
+		 */
+		virtual ~ScanCache();
+
+		/**
+		 * @brief Get the default cache file of a library, in $XDG_CACHE_HOME/id3 (or ~/.cache/id3, %LOCALAPPDATA%\\id3).
+		 *
+		 * @param library The scanned directory, its canonical path names the cache file.
+		 *
+		 * @return The cache file path, a hidden file in the library itself when no cache directory is known.
+		 */
+		static std::filesystem::path getDefaultPath(const std::filesystem::path& library);
+
+		/**
+		 * @brief Get the key of a file.
+		 *
+		 * @param file The file path.
+		 * @param key Set to the key of the file.
+		 *
+		 * @return true if the file could be stat'ed, false otherwise.
+		 */
+		static bool getKey(const std::filesystem::path& file, Key& key);
+
+		/**
+		 * @brief Load the entries of a cache file, replacing the current ones.
+		 *
+		 * @param file The cache file path.
+		 *
+		 * @return true if loaded, false if the file is missing, of another format version or damaged, the cache is then empty.
+		 */
+		bool load(const std::filesystem::path& file);
+
+		/**
+		 * @brief Write the entries found or stored since load() into a cache file, dropping the ones of files no longer seen.
+		 *
+		 * The entries are written to a temporary file renamed over the cache file, so a reader never sees a partial cache.
+		 *
+		 * @param file The cache file path, its directory is created if needed.
+		 *
+		 * @return true if successful, false otherwise.
+		 */
+		bool save(const std::filesystem::path& file);
+
+		/**
+		 * @brief Find the entry of a file.
+		 *
+		 * @param key The key of the file, see getKey().
+		 * @param entry Set to the entry when found.
+		 *
+		 * @return true if found, false otherwise.
+		 */
+		bool find(const Key& key, Entry& entry);
+
+		/**
+		 * @brief Add or replace the entry of a file.
+		 *
+		 * @param key The key of the file, see getKey().
+		 * @param entry The entry to cache.
+		 */
+		void store(const Key& key, const Entry& entry);
+
+		/**
+		 * @brief Get the number of entries.
+		 *
+		 * @return The number of entries.
+		 */
+		std::size_t getSize() const;
+
+		/**
+		 * @brief Get the number of successful find() calls.
+		 *
+		 * @return The number of hits.
+		 */
+		uint64_t getHits() const;
+
+		/**
+		 * @brief Get the number of failed find() calls.
+		 *
+		 * @return The number of misses.
+		 */
+		uint64_t getMisses() const;
+
+	private:
+		/**
+		 * @brief Hash of a Key.
+		 */
+		struct KeyHash{
+			std::size_t operator()(const Key& key) const;
+		};
+
+		/**
+		 * @brief A cached entry and whether it was used since load().
+		 */
+		struct Slot{
+			Entry entry;	///< The cached entry.
+			bool used;		///< Whether the entry was found or stored since load().
+		};
+
+	private:
+		mutable std::mutex mutex;	///< Guards all members.
+		std::unordered_map<Key, Slot, KeyHash> entries;	///< Entries by file key.
+		uint64_t hits;		///< Successful find() calls.
+		uint64_t misses;	///< Failed find() calls.
+};
+
+#endif /* SCANCACHE_HPP */
@@ -0,0 +1,711 @@
+#include "TagConverter.hpp"
+#include "ID3v20.hpp"
+#include "ID3v23.hpp"
+#include "ID3v24.hpp"
+#include "ID3v2FrameView.hpp"
+
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Where each field lives in every version, in the order of TagConverter::Field.
+ */
+static const struct{
+	const char* id3v20;		///< Frame identifier in ID3v2.0.
+	const char* id3v23;		///< Frame identifier in ID3v2.3.
+	const char* id3v24;		///< Frame identifier in ID3v2.4.
+	std::size_t offset;		///< Offset in the 128 bytes of an ID3v1 tag.
+	std::size_t size;		///< Size in an ID3v1.0 tag.
+} FIELDS[] = {
+	{"TT2", "TIT2", "TIT2", 3, 30},
+	{"TP1", "TPE1", "TPE1", 33, 30},
+	{"TAL", "TALB", "TALB", 63, 30},
+	{"TYE", "TYER", "TDRC", 93, 4},
+	{"COM", "COMM", "COMM", 97, 30},
+	{"TRK", "TRCK", "TRCK", 126, 1},
+	{"TCO", "TCON", "TCON", 127, 1}
+};
+
+/**
+ * @brief Names of the versions, as read by TagConverter::parseVersions().
+ */
+static const struct{
+	TagProbe::Version version;
+	const char* name;
+} VERSION_NAMES[] = {
+	{TagProbe::ID3v10, "v1.0"},
+	{TagProbe::ID3v11, "v1.1"},
+	{TagProbe::ID3v20, "v2.0"},
+	{TagProbe::ID3v23, "v2.3"},
+	{TagProbe::ID3v24, "v2.4"}
+};
+
+/**
+ * @brief Size of the comment of an ID3v1.1 tag, the byte after it must stay 0 for the track to be read.
+ */
+static const std::size_t ID3V11_COMMENT_SIZE = 28;
+
+/**
+ * @brief Genre byte of an ID3v1 tag without genre.
+ */
+static const uint8_t ID3V1_NO_GENRE = 0xFF;
+
+/**
+ * @brief Get the identifier of a field in the given ID3v2 version.
+ */
+static const char* getIdentifier(int field, TagProbe::Version version){
+	switch(version){
+		case TagProbe::ID3v20: return FIELDS[field].id3v20;
+		case TagProbe::ID3v24: return FIELDS[field].id3v24;
+		default: return FIELDS[field].id3v23;
+	}
+}
+
+/**
+ * @brief Get the major version of an ID3v2 TagProbe::Version, 0 for the others.
+ */
+static uint8_t getMajorVersion(TagProbe::Version version){
+	switch(version){
+		case TagProbe::ID3v20: return 2;
+		case TagProbe::ID3v23: return 3;
+		case TagProbe::ID3v24: return 4;
+		default: return 0;
+	}
+}
+
+/**
+ * @brief Bytes before the strings of a frame payload: the encoding, plus the language of comments and lyrics.
+ */
+static std::size_t getTextOffset(const uint8_t* identifier, uint8_t version){
+	bool hasLanguage = version == 2 ? (std::memcmp(identifier, "COM", 3) == 0 || std::memcmp(identifier, "ULT", 3) == 0) :
+		(std::memcmp(identifier, "COMM", 4) == 0 || std::memcmp(identifier, "USLT", 4) == 0);
+	return hasLanguage == true ? 4 : 1;
+}
+
+/**
+ * @brief Check if a frame holds an encoding byte followed by strings: text frames, comments and lyrics.
+ */
+static bool isTextFrame(const uint8_t* identifier, uint8_t version){
+	return identifier[0] == 'T' || getTextOffset(identifier, version) == 4;
+}
+
+/**
+ * @brief Decode the NUL separated strings that follow the encoding byte of an ID3v2 payload.
+ */
+static std::vector<std::u32string> decodeStrings(const uint8_t* in, std::size_t size, uint8_t encoding){
+	std::vector<std::u32string> strings(1);
+	bool isWide = encoding == 1 || encoding == 2;
+	bool isBigEndian = true;
+	bool atStart = true;
+
+	for(std::size_t i = 0; i < size; ){
+		uint32_t codePoint;
+		if(isWide == true){
+			if(i + 1 >= size){
+				break;
+			}
+			uint32_t unit = isBigEndian == true ? (in[i] << 8 | in[i + 1]) : (in[i + 1] << 8 | in[i]);
+			if(atStart == true && encoding == 1 && (unit == 0xFEFF || unit == 0xFFFE)){
+				// The byte order mark was read in the current order, swapped if it is the other one
+				isBigEndian = (unit == 0xFEFF) == isBigEndian;
+				i += 2;
+				atStart = false;
+				continue;
+			}
+			i += 2;
+			codePoint = unit;
+			if(unit >= 0xD800 && unit < 0xDC00 && i + 1 < size){
+				uint32_t low = isBigEndian == true ? (in[i] << 8 | in[i + 1]) : (in[i + 1] << 8 | in[i]);
+				if(low >= 0xDC00 && low < 0xE000){
+					codePoint = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+					i += 2;
+				}
+			}
+		}else if(encoding == 3 && in[i] >= 0xC0){
+			std::size_t length = in[i] >= 0xF0 ? 4 : in[i] >= 0xE0 ? 3 : 2;
+			codePoint = in[i] & (0x3F >> (length - 1));
+			std::size_t j = 1;
+			for(; j < length && i + j < size && (in[i + j] & 0xC0) == 0x80; j++){
+				codePoint = codePoint << 6 | (in[i + j] & 0x3F);
+			}
+			codePoint = j == length ? codePoint : 0xFFFD;
+			i += j;
+		}else{
+			codePoint = in[i];
+			i++;
+		}
+		atStart = false;
+
+		if(codePoint == 0){
+			strings.emplace_back();
+			atStart = true;
+			isBigEndian = true;
+			continue;
+		}
+		strings.back() += static_cast<char32_t>(codePoint);
+	}
+
+	// A terminator after the last string does not start another one
+	if(strings.size() > 1 && strings.back().empty() == true){
+		strings.pop_back();
+	}
+	return strings;
+}
+
+/**
+ * @brief Encode strings in ISO-8859-1 (0), UTF-16 with byte order mark (1) or UTF-8 (3), separated by NUL.
+ */
+static void encodeStrings(const std::vector<std::u32string>& strings, uint8_t encoding, std::string& out){
+	for(std::size_t i = 0; i < strings.size(); i++){
+		if(i > 0){
+			out.append(encoding == 1 ? 2 : 1, '\0');
+		}
+		if(encoding == 1){
+			out += "\xFF\xFE";
+		}
+		for(char32_t codePoint : strings[i]){
+			if(encoding == 0){
+				out += codePoint < 0x100 ? static_cast<char>(codePoint) : '?';
+			}else if(encoding == 1){
+				if(codePoint >= 0x10000){
+					uint32_t value = codePoint - 0x10000;
+					uint32_t high = 0xD800 + (value >> 10);
+					uint32_t low = 0xDC00 + (value & 0x3FF);
+					out += static_cast<char>(high & 0xFF);
+					out += static_cast<char>(high >> 8);
+					out += static_cast<char>(low & 0xFF);
+					out += static_cast<char>(low >> 8);
+				}else{
+					out += static_cast<char>(codePoint & 0xFF);
+					out += static_cast<char>(codePoint >> 8);
+				}
+			}else if(codePoint < 0x80){
+				out += static_cast<char>(codePoint);
+			}else if(codePoint < 0x800){
+				out += static_cast<char>(0xC0 | (codePoint >> 6));
+				out += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}else if(codePoint < 0x10000){
+				out += static_cast<char>(0xE0 | (codePoint >> 12));
+				out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}else{
+				out += static_cast<char>(0xF0 | (codePoint >> 18));
+				out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+				out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+		}
+	}
+}
+
+/**
+ * @brief Get the strings of a payload, after its encoding byte and language.
+ */
+static std::vector<std::u32string> getStrings(const std::string& payload, std::size_t textOffset){
+	if(payload.size() <= textOffset){
+		return std::vector<std::u32string>(1);
+	}
+	return decodeStrings(reinterpret_cast<const uint8_t*>(payload.data()) + textOffset, payload.size() - textOffset, static_cast<uint8_t>(payload[0]));
+}
+
+/**
+ * @brief Rewrite a payload in an encoding ID3v2.0 and ID3v2.3 have, false if it already has one.
+ *
+ * ISO-8859-1 is used when all characters fit, UTF-16 otherwise.
+ */
+static bool toID3v23Encoding(const std::string& payload, std::size_t textOffset, std::string& out){
+	if(payload.size() < textOffset || (payload[0] != 2 && payload[0] != 3)){
+		return false;
+	}
+
+	std::vector<std::u32string> strings = getStrings(payload, textOffset);
+	uint8_t encoding = 0;
+	for(const std::u32string& string : strings){
+		for(char32_t codePoint : string){
+			if(codePoint >= 0x100){
+				encoding = 1;
+			}
+		}
+	}
+
+	out.assign(1, static_cast<char>(encoding));
+	out.append(payload, 1, textOffset - 1);
+	encodeStrings(strings, encoding, out);
+	return true;
+}
+
+/**
+ * @brief An ID3v2.3 or ID3v2.4 frame payload split into the bytes its flags add before the data, and the data.
+ */
+struct StoredFrame{
+	uint8_t status = 0;			///< Preservation and read only flags, in the ID3v2.3 layout.
+	bool isCompressed = false;	///< Whether the data is compressed.
+	bool isEncrypted = false;	///< Whether the data is encrypted.
+	bool isGrouped = false;		///< Whether the frame belongs to a group.
+	uint32_t dataLength = 0;	///< Size of the compressed data once decompressed.
+	uint8_t method = 0;			///< Encryption method.
+	uint8_t group = 0;			///< Group identifier.
+	std::string data;			///< The data as stored, compressed and encrypted.
+};
+
+/**
+ * @brief Split a frame payload by the flags of the given version, false if it can not hold what they add.
+ *
+ * The bytes are added in the order of their flags: decompressed size, encryption method and group in ID3v2.3,
+ * group, encryption method and data length indicator in ID3v2.4, where compression requires the indicator.
+ */
+static bool readStoredFrame(const uint8_t* payload, uint32_t size, const uint8_t flags[2], uint8_t version, StoredFrame& frame){
+	bool hasDataLengthIndicator = false;
+	std::vector<uint8_t> resynchronized;
+	if(version == 4){
+		frame.status = static_cast<uint8_t>((flags[0] & 0x70) << 1);
+		frame.isGrouped = (flags[1] & 0x40) != 0;
+		frame.isCompressed = (flags[1] & 0x08) != 0;
+		frame.isEncrypted = (flags[1] & 0x04) != 0;
+		hasDataLengthIndicator = (flags[1] & 0x01) != 0;
+
+		// Only a frame kept as stored is still unsynchronized, ID3v2.3 has no such frame flag
+		if((flags[1] & 0x02) != 0){
+			resynchronized.reserve(size);
+			for(uint32_t i = 0; i < size; i++){
+				resynchronized.push_back(payload[i]);
+				if(payload[i] == 0xFF && i + 1 < size && payload[i + 1] == 0x00){
+					i++;
+				}
+			}
+			payload = resynchronized.data();
+			size = static_cast<uint32_t>(resynchronized.size());
+		}
+		if(frame.isCompressed == true && hasDataLengthIndicator == false){
+			return false;
+		}
+	}else{
+		frame.status = flags[0] & 0xE0;
+		frame.isCompressed = (flags[1] & 0x80) != 0;
+		frame.isEncrypted = (flags[1] & 0x40) != 0;
+		frame.isGrouped = (flags[1] & 0x20) != 0;
+	}
+
+	uint32_t added = (frame.isGrouped == true ? 1 : 0) + (frame.isEncrypted == true ? 1 : 0) +
+		(frame.isCompressed == true || hasDataLengthIndicator == true ? 4 : 0);
+	if(size < added){
+		return false;
+	}
+
+	uint32_t position = 0;
+	if(version == 3 && frame.isCompressed == true){
+		frame.dataLength = static_cast<uint32_t>(payload[0]) << 24 | payload[1] << 16 | payload[2] << 8 | payload[3];
+		position += 4;
+	}
+	if(version == 4 && frame.isGrouped == true){
+		frame.group = payload[position++];
+	}
+	if(frame.isEncrypted == true){
+		frame.method = payload[position++];
+	}
+	if(version == 3 && frame.isGrouped == true){
+		frame.group = payload[position++];
+	}
+	if(version == 4 && hasDataLengthIndicator == true){
+		const uint8_t* length = &payload[position];
+		frame.dataLength = static_cast<uint32_t>(length[0] & 0x7F) << 21 | (length[1] & 0x7F) << 14 | (length[2] & 0x7F) << 7 | (length[3] & 0x7F);
+		position += 4;
+	}
+
+	frame.data.assign(reinterpret_cast<const char*>(&payload[position]), size - position);
+	return true;
+}
+
+/**
+ * @brief Write a frame split by readStoredFrame() in the layout of the given version, false if it can not hold it.
+ *
+ * @param frame The split frame.
+ * @param identifier The frame identifier, text not compressed nor encrypted is rewritten in an encoding ID3v2.3 has.
+ * @param version The target version, 3 or 4.
+ * @param flags Set to the frame flags in the target layout.
+ * @param payload Set to the payload in the target layout.
+ */
+static bool writeStoredFrame(const StoredFrame& frame, const uint8_t* identifier, uint8_t version, uint8_t flags[2], std::string& payload){
+	std::string data = frame.data;
+	std::string encoded;
+	if(version == 3 && frame.isCompressed == false && frame.isEncrypted == false && isTextFrame(identifier, 3) == true &&
+		toID3v23Encoding(data, getTextOffset(identifier, 3), encoded) == true){
+		data.swap(encoded);
+	}
+
+	payload.clear();
+	if(version == 4){
+		// The data length indicator is synchsafe, 28 bits
+		if(frame.isCompressed == true && frame.dataLength > 0x0FFFFFFF){
+			return false;
+		}
+		flags[0] = static_cast<uint8_t>(frame.status >> 1);
+		flags[1] = static_cast<uint8_t>((frame.isGrouped == true ? 0x40 : 0) | (frame.isCompressed == true ? 0x09 : 0) | (frame.isEncrypted == true ? 0x04 : 0));
+		if(frame.isGrouped == true){
+			payload.push_back(static_cast<char>(frame.group));
+		}
+		if(frame.isEncrypted == true){
+			payload.push_back(static_cast<char>(frame.method));
+		}
+		if(frame.isCompressed == true){
+			for(int shift = 21; shift >= 0; shift -= 7){
+				payload.push_back(static_cast<char>((frame.dataLength >> shift) & 0x7F));
+			}
+		}
+	}else{
+		flags[0] = frame.status;
+		flags[1] = static_cast<uint8_t>((frame.isCompressed == true ? 0x80 : 0) | (frame.isEncrypted == true ? 0x40 : 0) | (frame.isGrouped == true ? 0x20 : 0));
+		if(frame.isCompressed == true){
+			for(int shift = 24; shift >= 0; shift -= 8){
+				payload.push_back(static_cast<char>((frame.dataLength >> shift) & 0xFF));
+			}
+		}
+		if(frame.isEncrypted == true){
+			payload.push_back(static_cast<char>(frame.method));
+		}
+		if(frame.isGrouped == true){
+			payload.push_back(static_cast<char>(frame.group));
+		}
+	}
+	payload += data;
+	return true;
+}
+
+/**
+ * @brief Copy the frames of an ID3v2.3 tag into new frames of the ID3v2.4 layout, or the other way around.
+ *
+ * Compressed, encrypted and grouped frames keep their data as stored, the bytes their flags add and the flags
+ * themselves move to the target layout. A plain year frame, TYER or TDRC, is left out for the converted year.
+ *
+ * @return false, with frames empty, if a frame can not be carried over without losing it.
+ */
+static bool convertFrames(const ID3v23& tag, uint8_t from, uint8_t to, std::vector<ID3v23Frame*>& frames){
+	for(ID3v23Frame* frame : tag.frames){
+		const uint8_t* data = frame->getData();
+		if(data == nullptr){
+			continue;
+		}
+
+		StoredFrame stored;
+		std::string payload;
+		uint8_t flags[2] = {0, 0};
+		bool isYear = std::memcmp(frame->header.identifier, to == 4 ? "TYER" : "TDRC", 4) == 0;
+		bool success = readStoredFrame(data, frame->header.getFrameSize(), frame->header.flags, from, stored);
+		bool isPlain = stored.isCompressed == false && stored.isEncrypted == false && stored.isGrouped == false;
+		if(success == true && isYear == true && isPlain == true){
+			continue;
+		}
+
+		// A packed year would need its content rewritten
+		if(success == false || isYear == true || writeStoredFrame(stored, frame->header.identifier, to, flags, payload) == false){
+			for(ID3v23Frame* converted : frames){
+				delete converted;
+			}
+			frames.clear();
+			return false;
+		}
+
+		ID3v23Frame* converted = new ID3v23Frame();
+		std::memcpy(converted->header.identifier, frame->header.identifier, 4);
+		converted->setData(reinterpret_cast<const uint8_t*>(payload.data()), static_cast<uint32_t>(payload.size()));
+		std::memcpy(converted->header.flags, flags, 2);
+		frames.push_back(converted);
+	}
+	return true;
+}
+
+/**
+ * @brief Read a number at the start of a text, "7/12" or "(17)" for instance, -1 if there is none.
+ */
+static int readNumber(const std::u32string& text){
+	std::size_t i = !text.empty() && text[0] == U'(' ? 1 : 0;
+	int number = -1;
+	for(; i < text.size() && text[i] >= U'0' && text[i] <= U'9' && number < 1000; i++){
+		number = (number < 0 ? 0 : number * 10) + static_cast<int>(text[i] - U'0');
+	}
+	return number;
+}
+
+TagConverter::TagConverter() :
+	source(TagProbe::None){
+
+}
+
+TagConverter::~TagConverter(){
+
+}
+
+bool TagConverter::parseVersions(const std::string& names, uint32_t& versions){
+	versions = TagProbe::None;
+
+	std::size_t start = 0;
+	while(start <= names.size()){
+		std::size_t end = names.find('+', start);
+		std::string name = names.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+		bool isKnown = false;
+		for(const auto& version : VERSION_NAMES){
+			if(name == version.name){
+				versions |= version.version;
+				isKnown = true;
+			}
+		}
+		if(isKnown == false){
+			return false;
+		}
+
+		if(end == std::string::npos){
+			break;
+		}
+		start = end + 1;
+	}
+
+	// One tag of each family fits in a file
+	uint32_t id3v1 = versions & (TagProbe::ID3v10 | TagProbe::ID3v11);
+	uint32_t id3v2 = versions & (TagProbe::ID3v20 | TagProbe::ID3v23 | TagProbe::ID3v24);
+	return versions != TagProbe::None && (id3v1 & (id3v1 - 1)) == 0 && (id3v2 & (id3v2 - 1)) == 0;
+}
+
+std::string TagConverter::toString(uint32_t versions){
+	std::string names;
+	for(const auto& version : VERSION_NAMES){
+		if((versions & version.version) != 0){
+			names += names.empty() == true ? "" : "+";
+			names += version.name;
+		}
+	}
+	return names;
+}
+
+bool TagConverter::read(const MP3File& mp3, TagProbe::Version from){
+	source = TagProbe::None;
+	for(std::string& payload : payloads){
+		payload.clear();
+	}
+
+	const TagProbe& probe = mp3.getTagProbe();
+	TagProbe::Version version = from;
+	if(version == TagProbe::None){
+		for(TagProbe::Version candidate : {TagProbe::ID3v24, TagProbe::ID3v23, TagProbe::ID3v20, TagProbe::ID3v11, TagProbe::ID3v10}){
+			if(probe.has(candidate) == true){
+				version = candidate;
+				break;
+			}
+		}
+	}
+	if(version == TagProbe::None || probe.has(version) == false){
+		return false;
+	}
+
+	if(version == TagProbe::ID3v10 || version == TagProbe::ID3v11){
+		const uint8_t* tag = mp3.getID3v1Bytes();
+		if(tag == nullptr){
+			return false;
+		}
+
+		// Text fields become ISO-8859-1 payloads, without the NUL or space padding
+		for(int field = Title; field <= Comment; field++){
+			std::size_t size = field == Comment && version == TagProbe::ID3v11 ? ID3V11_COMMENT_SIZE : FIELDS[field].size;
+			const uint8_t* text = tag + FIELDS[field].offset;
+			std::size_t length = 0;
+			while(length < size && text[length] != 0){
+				length++;
+			}
+			while(length > 0 && text[length - 1] == ' '){
+				length--;
+			}
+			if(length > 0){
+				payloads[field].assign(1, '\0');
+				if(field == Comment){
+					payloads[field].append("eng", 3).append(1, '\0');
+				}
+				payloads[field].append(reinterpret_cast<const char*>(text), length);
+			}
+		}
+		if(version == TagProbe::ID3v11 && tag[FIELDS[Track].offset] != 0){
+			payloads[Track] = std::string(1, '\0') + std::to_string(tag[FIELDS[Track].offset]);
+		}
+		if(tag[FIELDS[Genre].offset] != ID3V1_NO_GENRE){
+			payloads[Genre] = std::string(1, '\0') + "(" + std::to_string(tag[FIELDS[Genre].offset]) + ")";
+		}
+	}else{
+		for(const ID3v2FrameView& view : mp3.getFrameViews()){
+			for(int field = 0; field < FieldCount; field++){
+				if(payloads[field].empty() == false || view.isIdentifier(getIdentifier(field, version)) == false){
+					continue;
+				}
+
+				// Compressed and encrypted payloads can not be read as text, grouped ones are carried over as stored
+				bool isPacked = view.version == 3 ? (view.flags[1] & 0xE0) != 0 : view.version == 4 && (view.flags[1] & 0x4C) != 0;
+				if(isPacked == true){
+					continue;
+				}
+				if(view.version == 4 && (view.flags[1] & 0x03) != 0){
+					ID3v23Frame* frame = view.toID3v23Frame();
+					payloads[field].assign(reinterpret_cast<const char*>(frame->getData()), frame->header.getFrameSize());
+					delete frame;
+				}else{
+					payloads[field].assign(reinterpret_cast<const char*>(view.data), view.size);
+				}
+			}
+		}
+	}
+
+	source = version;
+	return true;
+}
+
+TagProbe::Version TagConverter::getSource() const{
+	return source;
+}
+
+bool TagConverter::convert(uint32_t targets, ID3& id3, uint32_t* failed) const{
+	if(failed != nullptr){
+		*failed = TagProbe::None;
+	}
+	if(source == TagProbe::None){
+		return false;
+	}
+
+	bool changed = false;
+	for(TagProbe::Version target : {TagProbe::ID3v10, TagProbe::ID3v11}){
+		if((targets & target) != 0){
+			changed = convertID3v1(target, id3) || changed;
+		}
+	}
+	for(TagProbe::Version target : {TagProbe::ID3v20, TagProbe::ID3v23, TagProbe::ID3v24}){
+		if((targets & target) != 0){
+			bool lossy = false;
+			changed = convertID3v2(target, id3, lossy) || changed;
+			if(lossy == true && failed != nullptr){
+				*failed |= target;
+			}
+		}
+	}
+	return changed;
+}
+
+bool TagConverter::convertID3v1(TagProbe::Version target, ID3& id3) const{
+	if(target == source){
+		return false;
+	}
+
+	uint8_t tag[sizeof(ID3v10Data)] = {'T', 'A', 'G'};
+	for(int field = Title; field <= Comment; field++){
+		std::size_t size = field == Comment && target == TagProbe::ID3v11 ? ID3V11_COMMENT_SIZE : FIELDS[field].size;
+		std::vector<std::u32string> strings = getStrings(payloads[field], field == Comment ? 4 : 1);
+		const std::u32string& text = field == Comment ? (strings.size() > 1 ? strings[1] : std::u32string()) : strings[0];
+		for(std::size_t i = 0; i < size && i < text.size(); i++){
+			tag[FIELDS[field].offset + i] = text[i] < 0x100 ? static_cast<uint8_t>(text[i]) : '?';
+		}
+	}
+
+	if(target == TagProbe::ID3v11){
+		int track = readNumber(getStrings(payloads[Track], 1)[0]);
+		tag[FIELDS[Track].offset] = track > 0 && track < 0x100 ? static_cast<uint8_t>(track) : 0;
+	}
+
+	// A genre given by name has no number in ID3v1
+	tag[FIELDS[Genre].offset] = ID3V1_NO_GENRE;
+	if(payloads[Genre].empty() == false){
+		int genre = readNumber(getStrings(payloads[Genre], 1)[0]);
+		tag[FIELDS[Genre].offset] = genre >= 0 && genre < 0x100 ? static_cast<uint8_t>(genre) : static_cast<uint8_t>(ID3v10::Other);
+	}
+
+	id3.v1.clear();
+	if(target == TagProbe::ID3v11){
+		ID3v11* v11 = new ID3v11();
+		std::memcpy(&v11->data, tag, sizeof(tag));
+		id3.v1.v11 = v11;
+	}else{
+		ID3v10* v10 = new ID3v10();
+		std::memcpy(&v10->data, tag, sizeof(tag));
+		id3.v1.v10 = v10;
+	}
+	return true;
+}
+
+bool TagConverter::convertID3v2(TagProbe::Version target, ID3& id3, bool& failed) const{
+	failed = false;
+	if(target == source){
+		return false;
+	}
+
+	uint8_t version = getMajorVersion(target);
+	uint8_t existing = id3.v2.getVersion();
+
+	// The fields go in as payloads, rewritten only when the target lacks their encoding
+	std::string converted[FieldCount];
+	for(int field = 0; field < FieldCount; field++){
+		const std::string& payload = payloads[field];
+		converted[field] = payload;
+		if(payload.empty() == true || version == 4){
+			continue;
+		}
+		if(field == Year){
+			// TYER and TYE hold the 4 digits of the year, TDRC a whole timestamp
+			std::u32string year = getStrings(payload, 1)[0].substr(0, 4);
+			converted[field].assign(1, '\0');
+			encodeStrings({year}, 0, converted[field]);
+		}else{
+			toID3v23Encoding(payload, field == Comment ? 4 : 1, converted[field]);
+		}
+	}
+
+	if(version == 2){
+		ID3v20* tag = existing == 2 ? id3.v2.v20 : new ID3v20();
+		for(int field = 0; field < FieldCount; field++){
+			if(converted[field].empty() == true){
+				continue;
+			}
+			uint8_t identifier[3];
+			std::memcpy(identifier, FIELDS[field].id3v20, 3);
+			for(ID3v20Frame* frame = tag->getFrame(identifier); frame != nullptr; frame = tag->getFrame(identifier)){
+				tag->removeFrame(frame);
+			}
+			tag->setFrame(identifier, static_cast<uint32_t>(converted[field].size()), reinterpret_cast<uint8_t*>(&converted[field][0]));
+		}
+		if(existing != 2){
+			id3.v2.clear();
+			id3.v2.v20 = tag;
+		}
+		return true;
+	}
+
+	ID3v23* tag = nullptr;
+	if(existing == version){
+		tag = id3.v2.v23;
+	}else{
+		// Frames of the other version move over in the target layout, or the tag is left as it is
+		std::vector<ID3v23Frame*> frames;
+		if((existing == 3 || existing == 4) && convertFrames(*id3.v2.v23, existing, version, frames) == false){
+			failed = true;
+			return false;
+		}
+
+		tag = version == 4 ? new ID3v24() : new ID3v23();
+		for(ID3v23Frame* frame : frames){
+			tag->addFrame(frame);
+		}
+
+		id3.v2.clear();
+		if(version == 4){
+			id3.v2.v24 = static_cast<ID3v24*>(tag);
+		}else{
+			id3.v2.v23 = tag;
+		}
+	}
+
+	for(int field = 0; field < FieldCount; field++){
+		if(converted[field].empty() == true){
+			continue;
+		}
+		uint8_t identifier[4];
+		std::memcpy(identifier, getIdentifier(field, target), 4);
+		for(ID3v23Frame* frame : tag->getFrames(identifier)){
+			tag->removeFrame(frame);
+		}
+		tag->addFrame(identifier, static_cast<uint32_t>(converted[field].size()), reinterpret_cast<uint8_t*>(&converted[field][0]));
+	}
+	return true;
+}
@@ -0,0 +1,129 @@
+#ifndef TAGCONVERTER_HPP
+#define TAGCONVERTER_HPP
+
+/**
+ * @file TagConverter.hpp
+ *
+ * @author Evandro L. Vieira
+ *
+ * @brief This file contains the definition of the class TagConverter.
+ */
+
+#include "ID3.hpp"
+#include "MP3File.hpp"
+#include "TagProbe.hpp"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @class TagConverter
+ *
+ * @brief Table-driven conversion of the fields shared by ID3v1.0, ID3v1.1, ID3v2.0, ID3v2.3 and ID3v2.4.
+ *
+ * read() takes title, artist, album, year, comment, track and genre from one tag of a loaded file as bytes: the ID3v1
+ * fields as stored and the ID3v2 payloads through ID3v2FrameView, never through the string getters of the tag classes.
+ * convert() writes them into the target tags from a table of field positions and frame identifiers, copying ID3v2
+ * payloads as they are and transcoding text only when the target lacks its encoding (UTF-8 before ID3v2.4, anything
+ * but ISO-8859-1 in ID3v1). Between ID3v2.3 and ID3v2.4 the other frames of the tag are carried over as well, the
+ * compressed, encrypted and grouped ones as stored with their flags in the target layout; ID3v2.0 frames have other
+ * identifiers, so only the shared fields go to or come from it.
+ *
+ * The values read are kept by the converter, so one read() serves any number of convert() calls.
+ */
+class TagConverter{
+	public:
+		/**
+		 * @brief Default constructor, nothing read.
+		 */
+		TagConverter();
+
+		/**
+		 * @brief Default virtual destructor.
+		 */
+		virtual ~TagConverter();
+
+		/**
+		 * @brief Get the versions named in a list like "v1.1+v2.4".
+		 *
+		 * @param names Version names "v1.0", "v1.1", "v2.0", "v2.3" or "v2.4" separated by '+'.
+		 * @param versions Set to the TagProbe::Version bits of the names.
+		 *
+		 * @return true if all names are known and at most one ID3v1 and one ID3v2 version is named, false otherwise.
+		 */
+		static bool parseVersions(const std::string& names, uint32_t& versions);
+
+		/**
+		 * @brief Name the given versions the way parseVersions() reads them.
+		 *
+		 * @param versions TagProbe::Version bits.
+		 *
+		 * @return The names separated by '+', like "v1.1+v2.4".
+		 */
+		static std::string toString(uint32_t versions);
+
+		/**
+		 * @brief Read the fields of one tag of a loaded file.
+		 *
+		 * @param mp3 The file, loaded by File::load() or MP3File::loadTags().
+		 * @param from The TagProbe::Version of the tag to read, TagProbe::None for the ID3v2 tag or, without one, the ID3v1 tag.
+		 *
+		 * @return true if the tag was found, false otherwise.
+		 */
+		bool read(const MP3File& mp3, TagProbe::Version from = TagProbe::None);
+
+		/**
+		 * @brief Get the version of the tag read.
+		 *
+		 * @return The TagProbe::Version bit of the tag, TagProbe::None before a successful read().
+		 */
+		TagProbe::Version getSource() const;
+
+		/**
+		 * @brief Write the fields read into the target tags.
+		 *
+		 * A targeted ID3v1 or ID3v2 tag replaces the one in id3 of the same family, the other family is left as it is.
+		 * A target equal to the tag read leaves it unchanged.
+		 *
+		 * @param targets TagProbe::Version bits, at most one ID3v1 and one ID3v2 version.
+		 * @param id3 The tags of the file, as returned by MP3File::getID3(), changed in place.
+		 * @param failed Set to the TagProbe::Version bits of the targets whose tag was left as it is because a frame
+		 *               can not be carried over, such as an ID3v2.4 compressed frame without data length indicator.
+		 *
+		 * @return true if id3 was changed, false otherwise.
+		 */
+		bool convert(uint32_t targets, ID3& id3, uint32_t* failed = nullptr) const;
+
+	private:
+		/**
+		 * @brief Fields shared by all versions, the rows of the field table.
+		 */
+		enum Field{
+			Title,
+			Artist,
+			Album,
+			Year,
+			Comment,
+			Track,
+			Genre,
+			FieldCount
+		};
+
+		/**
+		 * @brief Write the fields into a new ID3v1.0 or ID3v1.1 tag.
+		 */
+		bool convertID3v1(TagProbe::Version target, ID3& id3) const;
+
+		/**
+		 * @brief Write the fields into the ID3v2 tag of id3, converted to the target version first.
+		 *
+		 * failed is set when a frame can not be carried over to the target version, id3 is then left unchanged.
+		 */
+		bool convertID3v2(TagProbe::Version target, ID3& id3, bool& failed) const;
+
+	private:
+		TagProbe::Version source;			///< Version of the tag read.
+		std::string payloads[FieldCount];	///< Fields as ID3v2 frame payloads, empty when missing.
+};
+
+#endif /* TAGCONVERTER_HPP */
@@ -0,0 +1,130 @@
+#include "TagProbe.hpp"
+
+/**
+ * @brief Size of an ID3v1 tag.
+ */
+static const uint64_t ID3V1_SIZE = 128;
+
+/**
+ * @brief Size of an ID3v2 header or footer.
+ */
+static const uint64_t ID3V2_HEADER_SIZE = 10;
+
+static uint32_t readSynchsafe(const uint8_t* in){
+	uint32_t value = 0;
+	value |= static_cast<uint32_t>(in[0] & 0x7F) << 21;
+	value |= static_cast<uint32_t>(in[1] & 0x7F) << 14;
+	value |= static_cast<uint32_t>(in[2] & 0x7F) << 7;
+	value |= static_cast<uint32_t>(in[3] & 0x7F);
+	return value;
+}
+
+TagProbe::TagProbe() :
+	versions(None), id3v2Size(0), id3v1Offset(0), appendedOffset(0), appendedSize(0), fileSize(0){
+
+}
+
+TagProbe::~TagProbe(){
+
+}
+
+void TagProbe::clear(){
+	versions = None;
+	id3v2Size = 0;
+	id3v1Offset = 0;
+	appendedOffset = 0;
+	appendedSize = 0;
+	fileSize = 0;
+}
+
+void TagProbe::probe(const uint8_t* data, uint64_t size, uint64_t fileSize){
+	clear();
+	this->fileSize = fileSize;
+	id3v1Offset = fileSize;
+
+	if(data == nullptr || size == 0){
+		return;
+	}
+
+	// Head: ID3v2 header
+	if(size >= ID3V2_HEADER_SIZE && data[0] == 'I' && data[1] == 'D' && data[2] == '3' && data[4] == 0){
+		uint8_t major = data[3];
+		if(major == 2 || major == 3 || major == 4){
+			versions |= major == 2 ? ID3v20 : major == 3 ? ID3v23 : ID3v24;
+
+			id3v2Size = ID3V2_HEADER_SIZE + readSynchsafe(&data[6]);
+			if(major == 4 && (data[5] & 0x10) != 0){
+				versions |= ID3v24Footer;
+				id3v2Size += ID3V2_HEADER_SIZE;
+			}
+			if(id3v2Size > fileSize){
+				id3v2Size = fileSize;
+			}
+		}
+	}
+
+	// Tail: ID3v1 tag, then an appended ID3v2.4 footer right before it or at the very end
+	uint64_t tailEnd = size;
+	if(size > ID3V1_SIZE){
+		const uint8_t* tag = &data[size - ID3V1_SIZE];
+		if(tag[0] == 'T' && tag[1] == 'A' && tag[2] == 'G'){
+			versions |= tag[125] == 0 && tag[126] != 0 ? ID3v11 : ID3v10;
+			id3v1Offset = fileSize - ID3V1_SIZE;
+			tailEnd -= ID3V1_SIZE;
+		}
+	}
+
+	uint64_t tailFileEnd = fileSize - (size - tailEnd);
+	if(tailEnd >= ID3V2_HEADER_SIZE && tailFileEnd > id3v2Size){
+		const uint8_t* footer = &data[tailEnd - ID3V2_HEADER_SIZE];
+		if(footer[0] == '3' && footer[1] == 'D' && footer[2] == 'I' && footer[3] == 4){
+			uint64_t tagSize = readSynchsafe(&footer[6]) + 2 * ID3V2_HEADER_SIZE;
+			if(tagSize <= tailFileEnd - id3v2Size){
+				versions |= ID3v24Appended;
+				appendedOffset = tailFileEnd - tagSize;
+				appendedSize = tagSize;
+			}
+		}
+	}
+}
+
+bool TagProbe::has(Version version) const{
+	return (versions & version) != 0;
+}
+
+bool TagProbe::hasID3v1() const{
+	return (versions & (ID3v10 | ID3v11)) != 0;
+}
+
+bool TagProbe::hasID3v2() const{
+	return (versions & (ID3v20 | ID3v23 | ID3v24)) != 0;
+}
+
+std::string TagProbe::toString() const{
+	static const struct{
+		Version version;
+		const char* name;
+	} NAMES[] = {
+		{ID3v10, "ID3v1.0"},
+		{ID3v11, "ID3v1.1"},
+		{ID3v20, "ID3v2.0"},
+		{ID3v23, "ID3v2.3"},
+		{ID3v24, "ID3v2.4"}
+	};
+
+	std::string result;
+	for(const auto& name : NAMES){
+		if(has(name.version) == true){
+			if(result.empty() == false){
+				result += ", ";
+			}
+			result += name.name;
+		}
+	}
+
+	if(result.empty() == true){
+		return "No ID3 tags found";
+	}
+
+	return result;
+}
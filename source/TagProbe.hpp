@@ -0,0 +1,138 @@
+#ifndef TAGPROBE_HPP
+#define TAGPROBE_HPP
+
+/**
+ * @file TagProbe.hpp
+ *
+ * @author Evandro L. Vieira
+ *
+ * @brief This file contains the definition of the class TagProbe.
+ */
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @class TagProbe
+ *
+ * @brief Result of a single pass over the head and tail of an MP3 file that locates all ID3 tags in it.
+ *
+ * @note Offsets are file offsets, also when the data only holds the head and tail of the file (see MP3File::loadTags()).
+ */
+class TagProbe{
+	public:
+		/**
+		 * @enum TagProbe::Version
+		 *
+		 * @brief Bits of TagProbe::versions, one per tag found.
+		 */
+		enum Version{
+			None = 0,				/**< No tag found. */
+			ID3v10 = 1 << 0,		/**< ID3v1.0 tag in the last 128 bytes. */
+			ID3v11 = 1 << 1,		/**< ID3v1.1 tag in the last 128 bytes. */
+			ID3v20 = 1 << 2,		/**< ID3v2.0 tag at the beginning. */
+			ID3v23 = 1 << 3,		/**< ID3v2.3 tag at the beginning. */
+			ID3v24 = 1 << 4,		/**< ID3v2.4 tag at the beginning. */
+			ID3v24Footer = 1 << 5,	/**< The ID3v2.4 tag at the beginning has a footer. */
+			ID3v24Appended = 1 << 6	/**< ID3v2.4 tag with footer appended at the end, before an ID3v1 tag if any. */
+		};
+
+		/**
+		 * @brief Default constructor that initializes the object with no tag found.
+		 */
+		TagProbe();
+
+		/**
+		 * @brief Default virtual destructor.
+		 */
+		virtual ~TagProbe();
+
+		/**
+		 * @brief Reset to no tag found.
+		 */
+		void clear();
+
+		/**
+		 * @brief Locate the ID3 tags reading the header once and the tail once.
+		 *
+		 * @param data The loaded data, the whole file or its head followed by its tail.
+		 * @param size The size of data.
+		 * @param fileSize The size of the file on disk, equal to size when the whole file is loaded.
+		 */
+		void probe(const uint8_t* data, uint64_t size, uint64_t fileSize);
+
+		/**
+		 * @brief Check if the given tag was found.
+		 *
+		 * @param version One of TagProbe::Version bits.
+		 *
+		 * @return true if found, false otherwise.
+		 */
+		bool has(Version version) const;
+
+		/**
+		 * @brief Check if an ID3v1.0 or ID3v1.1 tag was found.
+		 *
+		 * @return true if found, false otherwise.
+		 */
+		bool hasID3v1() const;
+
+		/**
+		 * @brief Check if an ID3v2.0, ID3v2.3 or ID3v2.4 tag was found at the beginning.
+		 *
+		 * @return true if found, false otherwise.
+		 */
+		bool hasID3v2() const;
+
+		/**
+		 * @brief List the tag versions found.
+		 *
+		 * @return The versions separated by comma, like "ID3v1.1, ID3v2.3", or "No ID3 tags found".
+		 */
+		std::string toString() const;
+
+	public:
+		/**
+		 * @var uint32_t TagProbe::versions
+		 *
+		 * @brief Bitmask of TagProbe::Version of the tags found.
+		 */
+		uint32_t versions;
+
+		/**
+		 * @var uint64_t TagProbe::id3v2Size
+		 *
+		 * @brief Size of the ID3v2 tag at offset 0, header, frames, padding and footer, or 0.
+		 */
+		uint64_t id3v2Size;
+
+		/**
+		 * @var uint64_t TagProbe::id3v1Offset
+		 *
+		 * @brief Offset of the ID3v1 tag, the file size when there is none.
+		 */
+		uint64_t id3v1Offset;
+
+		/**
+		 * @var uint64_t TagProbe::appendedOffset
+		 *
+		 * @brief Offset of the appended ID3v2.4 tag, header included, or 0.
+		 */
+		uint64_t appendedOffset;
+
+		/**
+		 * @var uint64_t TagProbe::appendedSize
+		 *
+		 * @brief Size of the appended ID3v2.4 tag, header and footer included, or 0.
+		 */
+		uint64_t appendedSize;
+
+		/**
+		 * @var uint64_t TagProbe::fileSize
+		 *
+		 * @brief Size of the probed file.
+		 */
+		uint64_t fileSize;
+};
+
+#endif /* TAGPROBE_HPP */